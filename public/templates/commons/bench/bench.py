@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""
+Runs a benchmark build of a project (built with NEO_BENCH_FRAMES, see
+include/bench.h) and reports the CPU usage of every frame.
+
+The ROM runs in a headless mGBA, driven by a Lua script generated from the
+input script. The host build (see host/Makefile) can be benchmarked the
+same way with --host. Input scripts have one "<frame> <keys...>" line per
+change of the held keys, e.g. "120 A" then "121" to release it, or the
+log of a NEO_INPUT_RECORD build.
+
+    bench.py --rom game_bench.gba --frames 3600 --input bench/input.txt
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+KEYS = ['A', 'B', 'SELECT', 'START', 'RIGHT', 'LEFT', 'UP', 'DOWN', 'R', 'L']
+FULL_FRAME = 4096  # bn::fixed data of a whole frame
+PERCENTILES = [50, 90, 99]
+
+
+def read_inputs(path):
+    inputs = []
+
+    if not path or not os.path.exists(path):
+        if path:
+            print('No input script at ' + path + ', running without input')
+        return inputs
+
+    with open(path) as f:
+        for line in f:
+            # Recorded logs (NEO_INPUT_RECORD builds) carry a prefix
+            parts = line.split('[input]')[-1].split()
+
+            if not parts or not parts[0].isdigit():
+                continue
+
+            mask = 0
+
+            for key in parts[1:]:
+                if key not in KEYS:
+                    sys.exit('Unknown key in input script: ' + key)
+                mask |= 1 << KEYS.index(key)
+
+            inputs.append((int(parts[0]), mask))
+
+    return inputs
+
+
+def lua_script(inputs):
+    rows = ',\n'.join('  { %d, %d }' % i for i in inputs)
+
+    return '''local inputs = {
+%s
+}
+local next_input = 1
+
+callbacks:add("frame", function()
+  local frame = emu:currentFrame()
+
+  while next_input <= #inputs and inputs[next_input][1] <= frame do
+    emu:setKeys(inputs[next_input][2])
+    next_input = next_input + 1
+  end
+end)
+''' % rows
+
+
+def run(command, env):
+    """Returns the [bench] lines of the output, stops once the report is done"""
+    lines = []
+    process = subprocess.Popen(command, env=env, stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT, text=True,
+                               errors='replace')
+
+    for line in process.stdout:
+        if '[bench]' not in line:
+            continue
+
+        line = line[line.index('[bench]') + len('[bench]'):].strip()
+        lines.append(line)
+
+        if line == 'done':
+            break
+
+    process.kill()
+    process.wait()
+
+    if not lines or lines[-1] != 'done':
+        sys.exit('Benchmark did not finish, was the ROM built with NEO_BENCH_FRAMES?')
+
+    return lines
+
+
+def parse(lines):
+    scenes = {}
+    frames = []
+
+    for line in lines:
+        parts = line.split(' ', 3)
+
+        if parts[0] == 'scene':
+            scenes[int(parts[1])] = parts[2] if len(parts) == 3 else ' '.join(parts[2:])
+        elif parts[0] == 'frame':
+            frames.append((int(parts[1]), int(parts[2]), int(parts[3])))
+
+    return scenes, frames
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    rank = max(0, -(-len(ordered) * p // 100) - 1)  # Nearest rank
+    return ordered[rank] if ordered else 0
+
+
+def summary(values):
+    result = {'frames': len(values), 'max': max(values, default=0)}
+
+    for p in PERCENTILES:
+        result['p%d' % p] = percentile(values, p)
+
+    return result
+
+
+def to_percent(value):
+    return '%.1f%%' % (value * 100 / FULL_FRAME)
+
+
+def report(scenes, frames, previous):
+    total = summary([cpu for _, cpu, _ in frames])
+    by_scene = {}
+
+    for _, cpu, scene in frames:
+        by_scene.setdefault(scenes.get(scene, str(scene)), []).append(cpu)
+
+    dropped = [
+        {'frame': frame, 'cpu': cpu, 'scene': scenes.get(scene, str(scene))}
+        for frame, cpu, scene in frames if cpu > FULL_FRAME
+    ]
+
+    result = {
+        'total': total,
+        'scenes': {name: summary(values) for name, values in by_scene.items()},
+        'dropped': dropped,
+    }
+
+    def line(name, stats, before):
+        cells = []
+
+        for key in ['p%d' % p for p in PERCENTILES] + ['max']:
+            cell = key + ' ' + to_percent(stats[key])
+
+            if before and key in before:
+                delta = stats[key] - before[key]
+                cell += ' (%+.1f)' % (delta * 100 / FULL_FRAME) if delta else ''
+
+            cells.append(cell)
+
+        print('%-24s %6d frames  %s' % (name, stats['frames'], '  '.join(cells)))
+
+    line('All scenes', total, previous.get('total'))
+
+    for name, stats in result['scenes'].items():
+        line('  ' + name, stats, previous.get('scenes', {}).get(name))
+
+    print('%d dropped frames' % len(dropped))
+
+    for drop in dropped[:20]:
+        print('  frame %d: %s in %s' % (drop['frame'], to_percent(drop['cpu']), drop['scene']))
+
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument('--rom', help='ROM built with NEO_BENCH_FRAMES')
+    target.add_argument('--host', help='host executable built with NEO_BENCH_FRAMES')
+    parser.add_argument('--frames', type=int, default=3600)
+    parser.add_argument('--input', help='input script to replay')
+    parser.add_argument('--mgba', default='mgba-qt', help='mGBA executable, with Lua scripting')
+    parser.add_argument('--report', default='bench.json', help='JSON report, also the baseline of the next run')
+    args = parser.parse_args()
+
+    inputs = read_inputs(args.input)
+    env = dict(os.environ)
+
+    if args.host:
+        env['NEO_HOST_FRAMES'] = str(args.frames + 60)
+
+        with tempfile.NamedTemporaryFile('w', suffix='.txt', delete=False) as f:
+            f.writelines('%d %s\n' % (frame, ' '.join(k for i, k in enumerate(KEYS) if mask & (1 << i)))
+                         for frame, mask in inputs)
+            env['NEO_HOST_INPUT'] = f.name
+
+        lines = run([args.host], env)
+    else:
+        # Headless: no window and no sound device needed
+        env.setdefault('QT_QPA_PLATFORM', 'offscreen')
+        env.setdefault('SDL_VIDEODRIVER', 'dummy')
+        env.setdefault('SDL_AUDIODRIVER', 'dummy')
+
+        with tempfile.NamedTemporaryFile('w', suffix='.lua', delete=False) as f:
+            f.write(lua_script(inputs))
+
+        lines = run([args.mgba, '-l', '127', '--script', f.name, args.rom], env)
+
+    os.unlink(f.name)
+
+    scenes, frames = parse(lines)
+    previous = {}
+
+    if os.path.exists(args.report):
+        with open(args.report) as f:
+            previous = json.load(f)
+
+    result = report(scenes, frames, previous)
+
+    with open(args.report, 'w') as f:
+        json.dump(result, f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""
+Converts an input script, or the log of a NEO_INPUT_RECORD build, into the
+neo_replay.h table a NEO_INPUT_REPLAY build plays back (see include/input.h).
+
+    replay.py --input session.log --output build_replay/replay/neo_replay.h
+"""
+
+import argparse
+import os
+import sys
+
+from bench import KEYS, read_inputs
+
+
+def header(inputs):
+    rows = ''.join('    { %d, 0x%03x }, // %s\n' %
+                   (frame, mask, ' '.join(k for i, k in enumerate(KEYS) if mask & (1 << i)) or '-')
+                   for frame, mask in inputs)
+
+    return '''#ifndef NEO_REPLAY_H
+#define NEO_REPLAY_H
+
+#include "input.h"
+
+// Generated by replay.py, do not edit
+namespace neo::input
+{
+  constexpr int REPLAY_COUNT = %d;
+
+  constexpr change REPLAY[REPLAY_COUNT + 1] = {
+%s    { -1, 0 }
+  };
+}
+
+#endif
+''' % (len(inputs), rows)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--input', required=True, help='input script or recorded log')
+    parser.add_argument('--output', required=True, help='header to write')
+    args = parser.parse_args()
+
+    if not os.path.exists(args.input):
+        sys.exit('No input script at ' + args.input)
+
+    inputs = sorted(read_inputs(args.input))
+    content = header(inputs)
+
+    # Left untouched when unchanged, so the ROM isn't rebuilt for nothing
+    if os.path.exists(args.output):
+        with open(args.output) as f:
+            if f.read() == content:
+                return
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+
+    with open(args.output, 'w') as f:
+        f.write(content)
+
+    print('Replay of %d input changes written to %s' % (len(inputs), args.output))
+
+
+if __name__ == '__main__':
+    main()
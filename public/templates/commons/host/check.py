@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Replays an input script on the host build and checks the runtime log.
+
+Input scripts are the same as NEO_HOST_INPUT (see src/bn_host.cpp), with
+"# expect <count> <text>" lines: the run fails unless <text> is logged
+exactly <count> times. The replays in replays/ come with the scene they
+expect, create a project from it and build it once before running:
+
+    check.py --host /path/to/project/tmp/host/neo-host --input replays/interact_twice.txt
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+EXPECT = '# expect '
+
+
+def read_expectations(path):
+    expectations = []
+
+    with open(path) as f:
+        for line in f:
+            if not line.startswith(EXPECT):
+                continue
+
+            count, text = line[len(EXPECT):].strip().split(' ', 1)
+            expectations.append((int(count), text))
+
+    return expectations
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--host', required=True, help='host executable')
+    parser.add_argument('--input', required=True, help='input script to replay')
+    parser.add_argument('--frames', type=int, default=600)
+    args = parser.parse_args()
+
+    expectations = read_expectations(args.input)
+
+    if not expectations:
+        sys.exit('No "# expect" lines in ' + args.input)
+
+    env = dict(os.environ)
+    env['NEO_HOST_FRAMES'] = str(args.frames)
+    env['NEO_HOST_INPUT'] = args.input
+
+    process = subprocess.run([args.host], env=env, stdout=subprocess.PIPE,
+                             stderr=subprocess.STDOUT, text=True)
+    failed = process.returncode != 0
+
+    if failed:
+        print('Host build exited with %d' % process.returncode)
+
+    for count, text in expectations:
+        found = sum(text in line for line in process.stdout.splitlines())
+
+        if found != count:
+            print('Expected "%s" %d times, logged %d times' % (text, count, found))
+            failed = True
+
+    if failed:
+        sys.exit(1)
+
+    print('%s: %d checks passed' % (os.path.basename(args.input), len(expectations)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,751 @@
+#ifndef BN_HOST_H
+#define BN_HOST_H
+
+/**
+ * Headless stand-in for the subset of Butano used by the neo runtime, so
+ * the commons sources and a generated project can run natively. Every
+ * bn_*.h include resolves to this header (see stubs.sh), graphics calls
+ * only keep state and audio is silent.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+
+#ifndef BN_CFG_LOG_ENABLED
+  #define BN_CFG_LOG_ENABLED false
+#endif
+
+#define BN_CODE_IWRAM
+#define BN_CODE_EWRAM
+#define BN_DATA_EWRAM
+#define BN_DATA_EWRAM_BSS
+
+namespace bn
+{
+  template<typename T> constexpr const T& min(const T& a, const T& b) { return b < a ? b : a; }
+  template<typename T> constexpr const T& max(const T& a, const T& b) { return a < b ? b : a; }
+  template<typename T> constexpr T abs(T v) { return v < 0 ? -v : v; }
+  template<typename T> constexpr const T& clamp(const T& v, const T& lo, const T& hi) { return v < lo ? lo : (hi < v ? hi : v); }
+  template<typename T> constexpr void swap(T& a, T& b) { T t = a; a = b; b = t; }
+
+  void host_assert_failed(const char* condition, const char* file, int line);
+  [[nodiscard]] int host_frame(); // Frames elapsed since bn::core::init
+  [[nodiscard]] bool host_log_enabled();
+
+  // random, xorshift like Butano's so runs stay reproducible
+  class random
+  {
+    public:
+      [[nodiscard]] unsigned get() { _state ^= _state << 13; _state ^= _state >> 17; _state ^= _state << 5; return _state; }
+      [[nodiscard]] int get_int(int limit) { return limit > 0 ? int(get() % unsigned(limit)) : 0; }
+      [[nodiscard]] int get_int(int min, int limit) { return min + get_int(limit - min); }
+      void update() { _state ^= _state << 13; _state ^= _state >> 17; _state ^= _state << 5; }
+
+    private:
+      unsigned _state = 123456789;
+  };
+
+  // string_view
+  class string_view
+  {
+    public:
+      constexpr string_view() = default;
+      constexpr string_view(const char* s): _data(s), _size(_len(s)) {}
+      constexpr string_view(const char* s, int n): _data(s), _size(n) {}
+
+      [[nodiscard]] constexpr const char* data() const { return _data; }
+      [[nodiscard]] constexpr int size() const { return _size; }
+      [[nodiscard]] constexpr int length() const { return _size; }
+      [[nodiscard]] constexpr bool empty() const { return _size == 0; }
+      [[nodiscard]] constexpr const char* begin() const { return _data; }
+      [[nodiscard]] constexpr const char* end() const { return _data + _size; }
+      [[nodiscard]] constexpr char operator[](int i) const { return _data[i]; }
+      [[nodiscard]] constexpr char front() const { return _data[0]; }
+      [[nodiscard]] constexpr char back() const { return _data[_size - 1]; }
+      [[nodiscard]] constexpr string_view substr(int pos, int count = 1 << 30) const
+      {
+        int n = _size - pos;
+        return string_view(_data + pos, count < n ? count : n);
+      }
+      constexpr void remove_prefix(int n) { _data += n; _size -= n; }
+      constexpr void remove_suffix(int n) { _size -= n; }
+
+      [[nodiscard]] friend constexpr bool operator==(string_view a, string_view b)
+      {
+        if (a._size != b._size) return false;
+        for (int i = 0; i < a._size; ++i) if (a._data[i] != b._data[i]) return false;
+        return true;
+      }
+
+    private:
+      static constexpr int _len(const char* s) { int n = 0; while (s && s[n]) ++n; return n; }
+      const char* _data = "";
+      int _size = 0;
+  };
+
+  // fixed
+  template<int Precision>
+  class fixed_t
+  {
+    public:
+      static constexpr int scale() { return 1 << Precision; }
+
+      constexpr fixed_t() = default;
+      constexpr fixed_t(int v): _data(v * scale()) {}
+      constexpr fixed_t(float v): _data(int(v * scale())) {}
+      constexpr fixed_t(double v): _data(int(v * scale())) {}
+
+      [[nodiscard]] static constexpr fixed_t from_data(int d) { fixed_t r; r._data = d; return r; }
+      [[nodiscard]] constexpr int data() const { return _data; }
+      [[nodiscard]] constexpr int integer() const { return _data / scale(); }
+      [[nodiscard]] constexpr int right_shift_integer() const { return _data >> Precision; }
+      [[nodiscard]] constexpr int round_integer() const { return (_data + scale() / 2) >> Precision; }
+      [[nodiscard]] constexpr int floor_integer() const { return _data >> Precision; }
+      [[nodiscard]] constexpr int ceil_integer() const { return (_data + scale() - 1) >> Precision; }
+      [[nodiscard]] constexpr fixed_t fraction() const { return from_data(_data & (scale() - 1)); }
+      [[nodiscard]] constexpr float to_float() const { return float(_data) / scale(); }
+      [[nodiscard]] constexpr fixed_t unsafe_multiplication(fixed_t o) const { return from_data((_data * o._data) >> Precision); }
+      [[nodiscard]] constexpr fixed_t safe_multiplication(fixed_t o) const { return from_data(int((int64_t(_data) * o._data) >> Precision)); }
+      [[nodiscard]] constexpr fixed_t multiplication(fixed_t o) const { return safe_multiplication(o); }
+      [[nodiscard]] constexpr fixed_t division(fixed_t o) const { return from_data(int((int64_t(_data) << Precision) / o._data)); }
+      [[nodiscard]] constexpr explicit operator int() const { return integer(); }
+      [[nodiscard]] constexpr explicit operator float() const { return to_float(); }
+
+      constexpr fixed_t& operator+=(fixed_t o) { _data += o._data; return *this; }
+      constexpr fixed_t& operator-=(fixed_t o) { _data -= o._data; return *this; }
+      constexpr fixed_t& operator*=(fixed_t o) { *this = multiplication(o); return *this; }
+      constexpr fixed_t& operator*=(int o) { _data *= o; return *this; }
+      constexpr fixed_t& operator/=(fixed_t o) { *this = division(o); return *this; }
+      constexpr fixed_t& operator/=(int o) { _data /= o; return *this; }
+
+      [[nodiscard]] constexpr fixed_t operator-() const { return from_data(-_data); }
+      [[nodiscard]] friend constexpr fixed_t operator+(fixed_t a, fixed_t b) { return from_data(a._data + b._data); }
+      [[nodiscard]] friend constexpr fixed_t operator-(fixed_t a, fixed_t b) { return from_data(a._data - b._data); }
+      [[nodiscard]] friend constexpr fixed_t operator*(fixed_t a, fixed_t b) { return a.multiplication(b); }
+      [[nodiscard]] friend constexpr fixed_t operator*(fixed_t a, int b) { return from_data(a._data * b); }
+      [[nodiscard]] friend constexpr fixed_t operator/(fixed_t a, fixed_t b) { return a.division(b); }
+      [[nodiscard]] friend constexpr fixed_t operator/(fixed_t a, int b) { return from_data(a._data / b); }
+      [[nodiscard]] friend constexpr bool operator==(fixed_t a, fixed_t b) { return a._data == b._data; }
+      [[nodiscard]] friend constexpr bool operator<(fixed_t a, fixed_t b) { return a._data < b._data; }
+      [[nodiscard]] friend constexpr bool operator>(fixed_t a, fixed_t b) { return a._data > b._data; }
+      [[nodiscard]] friend constexpr bool operator<=(fixed_t a, fixed_t b) { return a._data <= b._data; }
+      [[nodiscard]] friend constexpr bool operator>=(fixed_t a, fixed_t b) { return a._data >= b._data; }
+
+    private:
+      int _data = 0;
+  };
+
+  using fixed = fixed_t<12>;
+
+  template<int Precision>
+  class fixed_point_t
+  {
+    public:
+      constexpr fixed_point_t() = default;
+      constexpr fixed_point_t(fixed_t<Precision> x, fixed_t<Precision> y): _x(x), _y(y) {}
+      [[nodiscard]] constexpr fixed_t<Precision> x() const { return _x; }
+      [[nodiscard]] constexpr fixed_t<Precision> y() const { return _y; }
+      constexpr void set_x(fixed_t<Precision> x) { _x = x; }
+      constexpr void set_y(fixed_t<Precision> y) { _y = y; }
+      [[nodiscard]] friend constexpr bool operator==(const fixed_point_t&, const fixed_point_t&) = default;
+
+    private:
+      fixed_t<Precision> _x;
+      fixed_t<Precision> _y;
+  };
+
+  using fixed_point = fixed_point_t<12>;
+
+  class size
+  {
+    public:
+      constexpr size() = default;
+      constexpr size(int w, int h): _w(w), _h(h) {}
+      [[nodiscard]] constexpr int width() const { return _w; }
+      [[nodiscard]] constexpr int height() const { return _h; }
+
+    private:
+      int _w = 0;
+      int _h = 0;
+  };
+
+  // span
+  template<typename T>
+  class span
+  {
+    public:
+      constexpr span() = default;
+      constexpr span(T* d, int n): _d(d), _n(n) {}
+      template<int N> constexpr span(T (&a)[N]): _d(a), _n(N) {}
+      [[nodiscard]] constexpr T* begin() const { return _d; }
+      [[nodiscard]] constexpr T* end() const { return _d + _n; }
+      [[nodiscard]] constexpr int size() const { return _n; }
+      [[nodiscard]] constexpr T& operator[](int i) const { return _d[i]; }
+
+    private:
+      T* _d = nullptr;
+      int _n = 0;
+  };
+
+  // optional
+  template<typename T>
+  class optional
+  {
+    public:
+      optional() = default;
+      optional(const T& v) { emplace(v); }
+      optional(const optional& o) { if (o._has) emplace(*o); }
+      optional& operator=(const optional& o) { if (this != &o) { reset(); if (o._has) emplace(*o); } return *this; }
+      optional& operator=(const T& v) { reset(); emplace(v); return *this; }
+      ~optional() { reset(); }
+
+      template<typename... Args> T& emplace(Args&&... args) { reset(); new (_storage) T(std::forward<Args>(args)...); _has = true; return **this; }
+      void reset() { if (_has) { (**this).~T(); _has = false; } }
+      [[nodiscard]] bool has_value() const { return _has; }
+      [[nodiscard]] explicit operator bool() const { return _has; }
+      [[nodiscard]] T& value() { if (!_has) host_assert_failed("optional has value", __FILE__, __LINE__); return **this; }
+      [[nodiscard]] const T& value() const { if (!_has) host_assert_failed("optional has value", __FILE__, __LINE__); return **this; }
+      [[nodiscard]] T& operator*() { return *reinterpret_cast<T*>(_storage); }
+      [[nodiscard]] const T& operator*() const { return *reinterpret_cast<const T*>(_storage); }
+      [[nodiscard]] T* operator->() { return &**this; }
+      [[nodiscard]] const T* operator->() const { return &**this; }
+
+    private:
+      alignas(T) unsigned char _storage[sizeof(T)];
+      bool _has = false;
+  };
+
+  // vector
+  template<typename T, int MaxSize>
+  class vector
+  {
+    public:
+      using iterator = T*;
+      using const_iterator = const T*;
+
+      vector() = default;
+      vector(const vector& o) { for (const T& v : o) push_back(v); }
+      vector(std::initializer_list<T> l) { for (const T& v : l) push_back(v); }
+      vector& operator=(const vector& o) { if (this != &o) { clear(); for (const T& v : o) push_back(v); } return *this; }
+      ~vector() { clear(); }
+
+      [[nodiscard]] int size() const { return _size; }
+      [[nodiscard]] static constexpr int max_size() { return MaxSize; }
+      [[nodiscard]] bool empty() const { return _size == 0; }
+      [[nodiscard]] bool full() const { return _size == MaxSize; }
+      [[nodiscard]] T* data() { return reinterpret_cast<T*>(_storage); }
+      [[nodiscard]] const T* data() const { return reinterpret_cast<const T*>(_storage); }
+      [[nodiscard]] iterator begin() { return data(); }
+      [[nodiscard]] iterator end() { return data() + _size; }
+      [[nodiscard]] const_iterator begin() const { return data(); }
+      [[nodiscard]] const_iterator end() const { return data() + _size; }
+      [[nodiscard]] T& operator[](int i) { _check(i); return data()[i]; }
+      [[nodiscard]] const T& operator[](int i) const { _check(i); return data()[i]; }
+      [[nodiscard]] T& at(int i) { _check(i); return data()[i]; }
+      [[nodiscard]] const T& at(int i) const { _check(i); return data()[i]; }
+      [[nodiscard]] T& front() { return data()[0]; }
+      [[nodiscard]] T& back() { return data()[_size - 1]; }
+      [[nodiscard]] const T& back() const { return data()[_size - 1]; }
+
+      void push_back(const T& v) { if (full()) host_assert_failed("vector is full", __FILE__, __LINE__); new (data() + _size) T(v); ++_size; }
+      template<typename... Args> T& emplace_back(Args&&... args)
+      {
+        if (full()) host_assert_failed("vector is full", __FILE__, __LINE__);
+        T* p = new (data() + _size) T(std::forward<Args>(args)...);
+        ++_size;
+        return *p;
+      }
+      void pop_back() { --_size; data()[_size].~T(); }
+      iterator erase(const_iterator pos)
+      {
+        int i = int(pos - data());
+        for (int k = i; k < _size - 1; ++k) data()[k] = data()[k + 1];
+        pop_back();
+        return data() + i;
+      }
+      void clear() { while (_size) pop_back(); }
+      void shrink(int count) { while (_size > count) pop_back(); }
+
+    private:
+      void _check(int i) const { if (i < 0 || i >= _size) host_assert_failed("vector index", __FILE__, __LINE__); }
+      alignas(T) unsigned char _storage[sizeof(T) * MaxSize];
+      int _size = 0;
+  };
+
+  // log
+  void host_log_begin();
+  void host_log_end();
+  inline void host_log_value(const char* v) { std::fputs(v, stderr); }
+  inline void host_log_value(string_view v) { std::fwrite(v.data(), 1, v.size(), stderr); }
+  inline void host_log_value(bool v) { std::fputs(v ? "true" : "false", stderr); }
+  inline void host_log_value(char v) { std::fputc(v, stderr); }
+  inline void host_log_value(int v) { std::fprintf(stderr, "%d", v); }
+  inline void host_log_value(unsigned v) { std::fprintf(stderr, "%u", v); }
+  inline void host_log_value(long v) { std::fprintf(stderr, "%ld", v); }
+  inline void host_log_value(unsigned long v) { std::fprintf(stderr, "%lu", v); }
+  inline void host_log_value(long long v) { std::fprintf(stderr, "%lld", v); }
+  inline void host_log_value(double v) { std::fprintf(stderr, "%g", v); }
+  inline void host_log_value(const void* v) { std::fprintf(stderr, "%p", v); }
+  template<int P> void host_log_value(fixed_t<P> v) { std::fprintf(stderr, "%g", double(v.data()) / (1 << P)); }
+  template<typename T> std::enable_if_t<std::is_enum_v<T>> host_log_value(T v) { host_log_value(int(v)); }
+
+  template<typename... Args>
+  void host_log(const Args&... args)
+  {
+    host_log_begin();
+    (host_log_value(args), ...);
+    host_log_end();
+  }
+
+  // core
+  namespace core
+  {
+    void init();
+    void update();
+    [[nodiscard]] fixed last_cpu_usage();
+    [[nodiscard]] fixed current_cpu_usage();
+    [[nodiscard]] int current_cpu_ticks();
+  }
+
+  namespace display
+  {
+    [[nodiscard]] constexpr int width() { return 240; }
+    [[nodiscard]] constexpr int height() { return 160; }
+  }
+
+  // keypad
+  namespace keypad
+  {
+    enum class key_type
+    {
+      A = 0x0001,
+      B = 0x0002,
+      SELECT = 0x0004,
+      START = 0x0008,
+      RIGHT = 0x0010,
+      LEFT = 0x0020,
+      UP = 0x0040,
+      DOWN = 0x0080,
+      R = 0x0100,
+      L = 0x0200,
+    };
+
+    [[nodiscard]] bool held(key_type key);
+    [[nodiscard]] bool pressed(key_type key);
+    [[nodiscard]] bool released(key_type key);
+    [[nodiscard]] bool any_held();
+    [[nodiscard]] bool any_pressed();
+    [[nodiscard]] bool any_released();
+
+#define BN_HOST_KEY(name, key) \
+    [[nodiscard]] inline bool name##_held() { return held(key_type::key); } \
+    [[nodiscard]] inline bool name##_pressed() { return pressed(key_type::key); } \
+    [[nodiscard]] inline bool name##_released() { return released(key_type::key); }
+
+    BN_HOST_KEY(a, A)
+    BN_HOST_KEY(b, B)
+    BN_HOST_KEY(select, SELECT)
+    BN_HOST_KEY(start, START)
+    BN_HOST_KEY(right, RIGHT)
+    BN_HOST_KEY(left, LEFT)
+    BN_HOST_KEY(up, UP)
+    BN_HOST_KEY(down, DOWN)
+    BN_HOST_KEY(r, R)
+    BN_HOST_KEY(l, L)
+
+#undef BN_HOST_KEY
+  }
+
+  // graphics
+  class camera_ptr
+  {
+    public:
+      [[nodiscard]] static camera_ptr create(fixed x, fixed y) { camera_ptr c; c._position = fixed_point(x, y); return c; }
+      [[nodiscard]] fixed x() const { return _position.x(); }
+      [[nodiscard]] fixed y() const { return _position.y(); }
+      [[nodiscard]] const fixed_point& position() const { return _position; }
+      void set_x(fixed x) { _position.set_x(x); }
+      void set_y(fixed y) { _position.set_y(y); }
+      void set_position(fixed x, fixed y) { _position = fixed_point(x, y); }
+      void set_position(const fixed_point& p) { _position = p; }
+
+    private:
+      fixed_point _position;
+  };
+
+  class sprite_shape_size
+  {
+    public:
+      constexpr sprite_shape_size(int w, int h): _w(w), _h(h) {}
+      [[nodiscard]] constexpr int width() const { return _w; }
+      [[nodiscard]] constexpr int height() const { return _h; }
+
+    private:
+      int _w;
+      int _h;
+  };
+
+  class sprite_tiles_ptr
+  {
+    public:
+      explicit sprite_tiles_ptr(int id, int graphics_index): _id(id), _graphics_index(graphics_index) {}
+      [[nodiscard]] int id() const { return _id; }
+      [[nodiscard]] int graphics_index() const { return _graphics_index; }
+      [[nodiscard]] friend bool operator==(const sprite_tiles_ptr&, const sprite_tiles_ptr&) = default;
+
+    private:
+      int _id;
+      int _graphics_index;
+  };
+
+  int host_vram_allocations();
+  int host_new_tiles_id();
+
+  class sprite_tiles_item
+  {
+    public:
+      constexpr sprite_tiles_item(const void* data, int graphics_count): _data(data), _graphics_count(graphics_count) {}
+      [[nodiscard]] constexpr int graphics_count() const { return _graphics_count; }
+      [[nodiscard]] sprite_tiles_ptr create_tiles(int graphics_index = 0) const { return sprite_tiles_ptr(host_new_tiles_id(), graphics_index); }
+      [[nodiscard]] sprite_tiles_ptr create_new_tiles(int graphics_index = 0) const { return create_tiles(graphics_index); }
+      [[nodiscard]] friend constexpr bool operator==(const sprite_tiles_item&, const sprite_tiles_item&) = default;
+
+    private:
+      const void* _data;
+      int _graphics_count;
+  };
+
+  class sprite_ptr
+  {
+    public:
+      sprite_ptr(const sprite_tiles_item& tiles, sprite_shape_size shape): _tiles(tiles.create_tiles(0)), _shape(shape) {}
+
+      [[nodiscard]] fixed x() const { return _position.x(); }
+      [[nodiscard]] fixed y() const { return _position.y(); }
+      [[nodiscard]] const fixed_point& position() const { return _position; }
+      void set_x(fixed x) { _position.set_x(x); }
+      void set_y(fixed y) { _position.set_y(y); }
+      void set_position(fixed x, fixed y) { _position = fixed_point(x, y); }
+      void set_position(const fixed_point& p) { _position = p; }
+      [[nodiscard]] size dimensions() const { return size(_shape.width(), _shape.height()); }
+      [[nodiscard]] bool visible() const { return _visible; }
+      void set_visible(bool v) { _visible = v; }
+      void set_bg_priority(int p) { _bg_priority = p; }
+      [[nodiscard]] int bg_priority() const { return _bg_priority; }
+      void set_z_order(int z) { _z_order = z; }
+      [[nodiscard]] int z_order() const { return _z_order; }
+      void set_camera(const camera_ptr& c) { _camera = &c; }
+      void remove_camera() { _camera = nullptr; }
+      void set_horizontal_flip(bool f) { _hflip = f; }
+      [[nodiscard]] bool horizontal_flip() const { return _hflip; }
+      void set_blending_enabled(bool b) { _blending = b; }
+      [[nodiscard]] const sprite_tiles_ptr& tiles() const { return _tiles; }
+      void set_tiles(const sprite_tiles_ptr& t) { _tiles = t; }
+      void set_tiles(const sprite_tiles_item& item, int graphics_index) { _tiles = item.create_tiles(graphics_index); }
+
+    private:
+      fixed_point _position;
+      sprite_tiles_ptr _tiles;
+      sprite_shape_size _shape;
+      const camera_ptr* _camera = nullptr;
+      int _bg_priority = 3;
+      int _z_order = 0;
+      bool _visible = true;
+      bool _hflip = false;
+      bool _blending = false;
+  };
+
+  class sprite_item
+  {
+    public:
+      constexpr sprite_item(const sprite_tiles_item& tiles, sprite_shape_size shape): _tiles(tiles), _shape(shape) {}
+      [[nodiscard]] constexpr const sprite_tiles_item& tiles_item() const { return _tiles; }
+      [[nodiscard]] constexpr sprite_shape_size shape_size() const { return _shape; }
+      [[nodiscard]] sprite_ptr create_sprite(fixed x, fixed y) const { sprite_ptr s(_tiles, _shape); s.set_position(x, y); return s; }
+      [[nodiscard]] sprite_ptr create_sprite(fixed x, fixed y, int graphics_index) const { sprite_ptr s = create_sprite(x, y); s.set_tiles(_tiles, graphics_index); return s; }
+
+    private:
+      sprite_tiles_item _tiles;
+      sprite_shape_size _shape;
+  };
+
+  class regular_bg_tiles_ptr
+  {
+    public:
+      explicit regular_bg_tiles_ptr(int id): _id(id) {}
+      [[nodiscard]] int id() const { return _id; }
+
+    private:
+      int _id;
+  };
+
+  class regular_bg_tiles_item
+  {
+    public:
+      constexpr explicit regular_bg_tiles_item(int tiles_count): _tiles_count(tiles_count) {}
+      [[nodiscard]] constexpr int tiles_count() const { return _tiles_count; }
+      [[nodiscard]] regular_bg_tiles_ptr create_tiles() const { return regular_bg_tiles_ptr(host_new_tiles_id()); }
+
+    private:
+      int _tiles_count;
+  };
+
+  class bg_palette_ptr
+  {
+  };
+
+  class bg_palette_item
+  {
+    public:
+      [[nodiscard]] bg_palette_ptr create_palette() const { return bg_palette_ptr(); }
+  };
+
+  using regular_bg_map_cell = uint16_t;
+
+  class regular_bg_map_cell_info
+  {
+    public:
+      constexpr regular_bg_map_cell_info() = default;
+      constexpr explicit regular_bg_map_cell_info(regular_bg_map_cell cell): _cell(cell) {}
+      [[nodiscard]] constexpr int tile_index() const { return _cell & 0x3FF; }
+      constexpr void set_tile_index(int index) { _cell = regular_bg_map_cell((_cell & ~0x3FF) | (index & 0x3FF)); }
+      [[nodiscard]] constexpr regular_bg_map_cell cell() const { return _cell; }
+
+    private:
+      regular_bg_map_cell _cell = 0;
+  };
+
+  int host_map_cell_writes();
+  void host_count_map_cell_write();
+
+  class regular_bg_map_ptr
+  {
+    public:
+      [[nodiscard]] static regular_bg_map_ptr allocate(const size& dimensions, regular_bg_tiles_ptr, bg_palette_ptr)
+      {
+        return regular_bg_map_ptr(dimensions);
+      }
+
+      [[nodiscard]] size dimensions() const { return _dimensions; }
+
+      void set_cell(int x, int y, regular_bg_map_cell)
+      {
+        if (x < 0 || x >= _dimensions.width() || y < 0 || y >= _dimensions.height())
+        {
+          host_assert_failed("Invalid map cell", __FILE__, __LINE__);
+        }
+
+        host_count_map_cell_write();
+      }
+
+    private:
+      explicit regular_bg_map_ptr(size dimensions): _dimensions(dimensions) {}
+
+      size _dimensions;
+  };
+
+  class regular_bg_ptr
+  {
+    public:
+      explicit regular_bg_ptr(size dimensions): _dimensions(dimensions) {}
+      [[nodiscard]] static regular_bg_ptr create(const regular_bg_map_ptr& map)
+      {
+        return regular_bg_ptr(size(map.dimensions().width() * 8, map.dimensions().height() * 8));
+      }
+      [[nodiscard]] size dimensions() const { return _dimensions; }
+      void set_camera(const camera_ptr& c) { _camera = &c; }
+      void remove_camera() { _camera = nullptr; }
+      void set_visible(bool v) { _visible = v; }
+      [[nodiscard]] bool visible() const { return _visible; }
+      void set_priority(int p) { _priority = p; }
+      void set_z_order(int z) { _z_order = z; }
+      void set_blending_enabled(bool b) { _blending = b; }
+      void set_position(fixed x, fixed y) { _position = fixed_point(x, y); }
+      [[nodiscard]] const fixed_point& position() const { return _position; }
+      void set_top_left_position(fixed x, fixed y)
+      {
+        _position = fixed_point(x - display::width() / 2 + _dimensions.width() / 2, y - display::height() / 2 + _dimensions.height() / 2);
+      }
+      [[nodiscard]] fixed_point top_left_position() const
+      {
+        return fixed_point(_position.x() + display::width() / 2 - _dimensions.width() / 2, _position.y() + display::height() / 2 - _dimensions.height() / 2);
+      }
+
+    private:
+      size _dimensions;
+      fixed_point _position;
+      const camera_ptr* _camera = nullptr;
+      int _priority = 3;
+      int _z_order = 0;
+      bool _visible = true;
+      bool _blending = false;
+  };
+
+  class regular_bg_item
+  {
+    public:
+      constexpr regular_bg_item(int width, int height): _width(width), _height(height) {}
+      [[nodiscard]] regular_bg_ptr create_bg(fixed x, fixed y) const { regular_bg_ptr bg(size(_width, _height)); bg.set_position(x, y); return bg; }
+
+    private:
+      int _width;
+      int _height;
+  };
+
+  namespace blending
+  {
+    [[nodiscard]] fixed fade_alpha();
+    void set_fade_alpha(fixed alpha);
+    void set_black_fade_color();
+    void set_white_fade_color();
+  }
+
+  class blending_fade_alpha_to_action
+  {
+    public:
+      blending_fade_alpha_to_action(int duration_updates, fixed final_alpha):
+        _initial(blending::fade_alpha()), _final(final_alpha), _duration(duration_updates) {}
+      void update()
+      {
+        if (_current < _duration) ++_current;
+        blending::set_fade_alpha(_initial + (_final - _initial) * _current / (_duration ? _duration : 1));
+      }
+      [[nodiscard]] bool done() const { return _current >= _duration; }
+
+    private:
+      fixed _initial;
+      fixed _final;
+      int _duration;
+      int _current = 0;
+  };
+
+  template<int MaxSize>
+  class sprite_animate_action
+  {
+    public:
+      sprite_animate_action(const sprite_ptr& sprite, int wait_updates, const sprite_tiles_item& tiles, std::initializer_list<uint16_t> indexes):
+        _sprite(sprite), _tiles(tiles), _wait_updates(wait_updates)
+      {
+        for (uint16_t i : indexes) _indexes.push_back(i);
+      }
+      void update()
+      {
+        if (++_counter >= _wait_updates)
+        {
+          _counter = 0;
+          _sprite.set_tiles(_tiles, _indexes[_current]);
+          _current = (_current + 1) % _indexes.size();
+        }
+      }
+      void reset() { _current = 0; _counter = 0; }
+
+    private:
+      sprite_ptr _sprite;
+      sprite_tiles_item _tiles;
+      vector<uint16_t, MaxSize> _indexes;
+      int _wait_updates;
+      int _counter = 0;
+      int _current = 0;
+  };
+
+  template<typename... Args>
+  [[nodiscard]] sprite_animate_action<sizeof...(Args)> create_sprite_animate_action_forever(
+    const sprite_ptr& sprite, int wait_updates, const sprite_tiles_item& tiles, Args... indexes)
+  {
+    return sprite_animate_action<sizeof...(Args)>(sprite, wait_updates, tiles, { uint16_t(indexes)... });
+  }
+
+  class sprite_font
+  {
+    public:
+      constexpr explicit sprite_font(const sprite_item& item): _item(item) {}
+      [[nodiscard]] constexpr const sprite_item& item() const { return _item; }
+
+    private:
+      sprite_item _item;
+  };
+
+  class sprite_text_generator
+  {
+    public:
+      explicit sprite_text_generator(const sprite_font& font): _font(font) {}
+      void set_left_alignment() {}
+      void set_center_alignment() {}
+      void set_bg_priority(int) {}
+      void set_z_order(int) {}
+      [[nodiscard]] int width(string_view text) const { return text.size() * 8; }
+      template<int N>
+      void generate(fixed x, fixed y, string_view text, vector<sprite_ptr, N>& output)
+      {
+        for (int i = 0; i < text.size(); i += 4) output.push_back(_font.item().create_sprite(x + i * 8, y));
+      }
+
+    private:
+      sprite_font _font;
+  };
+
+  // audio
+  class music_item
+  {
+    public:
+      constexpr explicit music_item(int id): _id(id) {}
+      void play(fixed volume = 1, bool loop = true) const;
+      [[nodiscard]] constexpr int id() const { return _id; }
+      [[nodiscard]] friend constexpr bool operator==(const music_item&, const music_item&) = default;
+
+    private:
+      int _id;
+  };
+
+  class sound_item
+  {
+    public:
+      constexpr explicit sound_item(int id): _id(id) {}
+      void play(fixed volume = 1) const { play_with_priority(0, volume, 1, 0); }
+      void play_with_priority(int priority, fixed volume, fixed speed, fixed panning) const;
+
+    private:
+      int _id;
+  };
+
+  namespace music
+  {
+    [[nodiscard]] bool playing();
+    [[nodiscard]] optional<music_item> playing_item();
+    [[nodiscard]] fixed volume();
+    void set_volume(fixed volume);
+    void stop();
+  }
+
+  namespace memory
+  {
+    [[nodiscard]] int used_alloc_ewram();
+    [[nodiscard]] int available_alloc_ewram();
+    [[nodiscard]] int used_static_iwram();
+    [[nodiscard]] int used_static_ewram();
+  }
+
+  template<typename Key, typename Value>
+  struct pair
+  {
+    Key first;
+    Value second;
+  };
+}
+
+#define BN_LOG(...) \
+  do { if constexpr (BN_CFG_LOG_ENABLED) { if (bn::host_log_enabled()) { bn::host_log(__VA_ARGS__); } } } while (false)
+
+#define BN_ASSERT(condition, ...) \
+  do { if (!(condition)) { bn::host_assert_failed(#condition, __FILE__, __LINE__); } } while (false)
+
+#define BN_ERROR(...) \
+  bn::host_assert_failed("error", __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,207 @@
+#include <chrono>
+
+#include "bn_host.h"
+
+/**
+ * Runtime of the Butano stand-in. Configured with environment variables:
+ *
+ * NEO_HOST_FRAMES: frames to run before exiting (default 3600, one minute)
+ * NEO_HOST_INPUT: input script, one "<frame> <keys...>" line per change of
+ *   the held keys, e.g. "120 A", "121" (nothing held) or "300 LEFT B".
+ *   Keys are A, B, SELECT, START, RIGHT, LEFT, UP, DOWN, R and L, lines
+ *   starting with # are ignored. A log of a NEO_INPUT_RECORD build works
+ *   too: only its "[input]" lines are read
+ * NEO_HOST_QUIET: any value hides BN_LOG output
+ */
+namespace
+{
+  constexpr int MAX_INPUTS = 4096;
+
+  struct input
+  {
+    int frame;
+    int mask;
+  };
+
+  input inputs[MAX_INPUTS];
+  int inputs_count = 0;
+  int next_input = 0;
+
+  int frame = 0;
+  int max_frames = 3600;
+  bool quiet = false;
+  int held_mask = 0;
+  int previous_mask = 0;
+  int tiles_ids = 0;
+  int map_cell_writes = 0;
+  bn::fixed fade_alpha_value = 0;
+  bool music_playing = false;
+  bn::fixed music_volume = 1;
+  std::chrono::steady_clock::time_point start_time;
+  std::chrono::steady_clock::time_point frame_start;
+  bn::fixed last_cpu = 0;
+
+  int key_mask(const char* name)
+  {
+    static constexpr const char* NAMES[] = {
+      "A", "B", "SELECT", "START", "RIGHT", "LEFT", "UP", "DOWN", "R", "L"
+    };
+
+    for (int i = 0; i < 10; ++i)
+    {
+      if (std::strcmp(name, NAMES[i]) == 0)
+      {
+        return 1 << i;
+      }
+    }
+
+    std::fprintf(stderr, "Unknown key in input script: %s\n", name);
+    return 0;
+  }
+
+  void load_inputs(const char* path)
+  {
+    std::FILE* file = std::fopen(path, "r");
+
+    if (file == nullptr)
+    {
+      std::fprintf(stderr, "Could not open input script: %s\n", path);
+      std::exit(1);
+    }
+
+    char line[256];
+
+    while (std::fgets(line, sizeof(line), file) != nullptr && inputs_count < MAX_INPUTS)
+    {
+      char* start = std::strstr(line, "[input]");
+      char* token = std::strtok(start != nullptr ? start + 7 : line, " \t\r\n");
+
+      if (token == nullptr || token[0] < '0' || token[0] > '9')
+      {
+        continue;
+      }
+
+      input& in = inputs[inputs_count++];
+      in.frame = std::atoi(token);
+      in.mask = 0;
+
+      while ((token = std::strtok(nullptr, " \t\r\n")) != nullptr)
+      {
+        in.mask |= key_mask(token);
+      }
+    }
+
+    std::fclose(file);
+  }
+
+  void report()
+  {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::fprintf(stderr, "Ran %d frames in %.3f s (%.2f us per frame), %d tile allocations, %d map cell writes\n",
+      frame, seconds, frame > 0 ? seconds * 1e6 / frame : 0.0, tiles_ids, map_cell_writes);
+  }
+}
+
+namespace bn
+{
+  void host_assert_failed(const char* condition, const char* file, int line)
+  {
+    std::fprintf(stderr, "ASSERT FAILED: %s (%s:%d) at frame %d\n", condition, file, line, frame);
+    std::abort();
+  }
+
+  bool host_log_enabled() { return !quiet; }
+  void host_log_begin() { std::fprintf(stderr, "[%06d] ", frame); }
+  void host_log_end() { std::fputc('\n', stderr); }
+
+  int host_frame() { return frame; }
+  int host_new_tiles_id() { return ++tiles_ids; }
+  int host_vram_allocations() { return tiles_ids; }
+  int host_map_cell_writes() { return map_cell_writes; }
+  void host_count_map_cell_write() { ++map_cell_writes; }
+
+  namespace core
+  {
+    void init()
+    {
+      if (const char* frames = std::getenv("NEO_HOST_FRAMES"))
+      {
+        max_frames = std::atoi(frames);
+      }
+
+      if (const char* path = std::getenv("NEO_HOST_INPUT"))
+      {
+        load_inputs(path);
+      }
+
+      quiet = std::getenv("NEO_HOST_QUIET") != nullptr;
+      start_time = std::chrono::steady_clock::now();
+      frame_start = start_time;
+      std::atexit(report);
+    }
+
+    void update()
+    {
+      // Host time spent on the frame relative to a GBA frame (59.73 Hz)
+      auto now = std::chrono::steady_clock::now();
+      last_cpu = bn::fixed(std::chrono::duration<double>(now - frame_start).count() * 59.73);
+      frame_start = now;
+      ++frame;
+
+      if (frame >= max_frames)
+      {
+        std::exit(0);
+      }
+
+      previous_mask = held_mask;
+
+      while (next_input < inputs_count && inputs[next_input].frame <= frame)
+      {
+        held_mask = inputs[next_input++].mask;
+      }
+    }
+
+    fixed last_cpu_usage() { return last_cpu; }
+    fixed current_cpu_usage() { return 0; }
+    int current_cpu_ticks() { return 0; }
+  }
+
+  namespace keypad
+  {
+    bool held(key_type key) { return held_mask & int(key); }
+    bool pressed(key_type key) { return (held_mask & int(key)) && !(previous_mask & int(key)); }
+    bool released(key_type key) { return !(held_mask & int(key)) && (previous_mask & int(key)); }
+    bool any_held() { return held_mask; }
+    bool any_pressed() { return held_mask & ~previous_mask; }
+    bool any_released() { return previous_mask & ~held_mask; }
+  }
+
+  namespace blending
+  {
+    fixed fade_alpha() { return fade_alpha_value; }
+    void set_fade_alpha(fixed alpha) { fade_alpha_value = alpha; }
+    void set_black_fade_color() {}
+    void set_white_fade_color() {}
+  }
+
+  void music_item::play(fixed volume, bool) const { music_playing = true; music_volume = volume; }
+  void sound_item::play_with_priority(int, fixed, fixed, fixed) const {}
+
+  namespace music
+  {
+    bool playing() { return music_playing; }
+    optional<music_item> playing_item() { if (music_playing) return music_item(0); return optional<music_item>(); }
+    fixed volume() { return music_volume; }
+    void set_volume(fixed volume) { music_volume = volume; }
+    void stop() { music_playing = false; }
+  }
+
+  namespace memory
+  {
+    int used_alloc_ewram() { return 0; }
+    int available_alloc_ewram() { return 256 * 1024; }
+    int used_static_iwram() { return 0; }
+    int used_static_ewram() { return 0; }
+  }
+}
@@ -0,0 +1,93 @@
+#!/bin/sh
+# Generates the headers the host build needs in place of Butano's:
+# every bn_*.h included by the sources forwards to bn_host.h, and the
+# asset headers Butano would generate from graphics and audio get
+# placeholder items with the same names.
+#
+# Usage: stubs.sh <output dir> <audio dir> <source dirs...>
+set -e
+
+OUT=$1
+AUDIO=$2
+shift 2
+
+mkdir -p "$OUT"
+
+INCLUDES=$(cat $(find "$@" -name '*.h' -o -name '*.cpp' 2>/dev/null) \
+  | grep -o 'bn_[a-z0-9_]*\.h' | sort -u)
+
+for inc in $INCLUDES; do
+  name=${inc#bn_}
+  name=${name%.h}
+
+  case $name in
+    regular_bg_items_*)
+      item=${name#regular_bg_items_}
+      printf '#pragma once\n#include "bn_host.h"\nnamespace bn::regular_bg_items { constexpr inline bn::regular_bg_item %s(256, 256); }\n' \
+        "$item" > "$OUT/$inc"
+      ;;
+    regular_bg_tiles_items_*)
+      item=${name#regular_bg_tiles_items_}
+      printf '#pragma once\n#include "bn_host.h"\nnamespace bn::regular_bg_tiles_items { constexpr inline bn::regular_bg_tiles_item %s(128); }\n' \
+        "$item" > "$OUT/$inc"
+      ;;
+    bg_palette_items_*)
+      item=${name#bg_palette_items_}
+      printf '#pragma once\n#include "bn_host.h"\nnamespace bn::bg_palette_items { constexpr inline bn::bg_palette_item %s; }\n' \
+        "$item" > "$OUT/$inc"
+      ;;
+    sprite_items_*)
+      item=${name#sprite_items_}
+      printf '#pragma once\n#include "bn_host.h"\nnamespace bn::sprite_items { inline constexpr int %s_data = 0; constexpr inline bn::sprite_item %s(bn::sprite_tiles_item(&%s_data, 10), bn::sprite_shape_size(16, 16)); }\n' \
+        "$item" "$item" "$item" > "$OUT/$inc"
+      ;;
+    music_items_info|sound_items_info|music_items|sound_items)
+      ;;
+    *)
+      [ -f "$(dirname "$0")/include/$inc" ] || \
+        printf '#pragma once\n#include "bn_host.h"\n' > "$OUT/$inc"
+      ;;
+  esac
+done
+
+# Audio items, music from tracker modules and sounds from wav files like
+# the maxmod backend of Butano
+audio_items () {
+  kind=$1
+  shift
+  index=0
+  names=""
+
+  for file in "$@"; do
+    [ -f "$file" ] || continue
+    name=$(basename "$file")
+    name=$(echo "${name%.*}" | tr 'A-Z' 'a-z')
+    names="$names $name"
+  done
+
+  {
+    printf '#pragma once\n#include "bn_host.h"\nnamespace bn::%s_items\n{\n' "$kind"
+    for name in $names; do
+      printf '  constexpr inline bn::%s_item %s(%d);\n' "$kind" "$name" "$index"
+      index=$((index + 1))
+    done
+    printf '}\n'
+  } > "$OUT/bn_${kind}_items.h"
+
+  {
+    printf '#pragma once\n#include "bn_%s_items.h"\nnamespace bn::%s_items_info\n{\n' "$kind" "$kind"
+    if [ -n "$names" ]; then
+      printf '  constexpr inline bn::pair<const bn::%s_item, bn::string_view> array[] = {\n' "$kind"
+      for name in $names; do
+        printf '    { bn::%s_items::%s, "%s" },\n' "$kind" "$name" "$name"
+      done
+      printf '  };\n  constexpr inline bn::span<const bn::pair<const bn::%s_item, bn::string_view>> span(array);\n' "$kind"
+    else
+      printf '  constexpr inline bn::span<const bn::pair<const bn::%s_item, bn::string_view>> span;\n' "$kind"
+    fi
+    printf '}\n'
+  } > "$OUT/bn_${kind}_items_info.h"
+}
+
+audio_items music "$AUDIO"/*.mod "$AUDIO"/*.xm "$AUDIO"/*.s3m "$AUDIO"/*.it
+audio_items sound "$AUDIO"/*.wav
@@ -13,11 +13,10 @@ namespace neo
   class actor
   {
     public:
-      actor(neo::game* game, neo::types::actor* actor_definition);
+      actor(neo::game* game, const neo::types::actor* actor_definition);
       ~actor(); // Destructor - called automatically when delete is used
 
       void init();
-      void update();
       void set_direction(neo::types::direction direction);
       void set_position(int tile_x, int tile_y);
       bool collides(int tile_x, int tile_y);
@@ -25,10 +24,16 @@ namespace neo
       void enable();
 
       neo::game* game;
-      neo::types::actor* definition;
+      const neo::types::actor* definition;
       bn::sprite_ptr sprite;
       bn::fixed_point position;
       neo::types::direction direction;
+
+      // Occupancy grid bookkeeping, only touched by neo::occupancy_grid
+      neo::actor* next_in_cell;
+      int cell_x;
+      int cell_y;
+      bool occupying;
   };
 }
 
@@ -0,0 +1,22 @@
+#ifndef NEO_BENCH_H
+#define NEO_BENCH_H
+
+#include <bn_core.h>
+#include <bn_string_view.h>
+
+/**
+ * Frame cost sampling for benchmark builds (make bench), which define
+ * NEO_BENCH_FRAMES. Samples are kept in EWRAM and only logged once every
+ * frame ran so logging them doesn't weigh on the numbers. Compiles to
+ * nothing in regular builds.
+ */
+namespace neo::bench
+{
+#ifdef NEO_BENCH_FRAMES
+  void sample(int scene_id, bn::string_view scene_name);
+#else
+  inline void sample(int, bn::string_view) {}
+#endif
+}
+
+#endif
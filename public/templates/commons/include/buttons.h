@@ -2,15 +2,73 @@
 #define NEO_BUTTONS_H
 
 #include <bn_core.h>
-#include <bn_keypad.h>
 #include <bn_vector.h>
-#include <bn_string_view.h>
+
+#include "neo_types.h"
+#include "input.h"
 
 namespace neo::buttons
 {
-  bool is_pressed(bn::string_view button);
-  bool any_pressed(const bn::vector<bn::string_view, 10>& buttons);
-  bool all_pressed(const bn::vector<bn::string_view, 10>& buttons);
+  /**
+   * Tests a button set against the keypad state of this frame. Sets are
+   * key masks folded at build time, so this is a couple of ANDs.
+   *
+   * With every, pressed fires the frame the last key of the set goes down
+   * while the others are held, and released the frame the first one comes
+   * back up after all of them were held.
+   */
+  bool fired(unsigned keys, neo::types::button_trigger trigger, bool every);
+
+  inline bool fired(const neo::types::button_event& event)
+  {
+    return fired(event.keys, event.trigger, event.every);
+  }
+
+  /**
+   * on-button-press handlers of the running scene, registered once when
+   * the scene events reach them. Each trigger keeps the union of its
+   * handlers' masks, so frames where no watched key changes (or, for held
+   * handlers, is down) are rejected before looking at any handler.
+   */
+  class dispatcher
+  {
+    public:
+      static constexpr int MAX_HANDLERS = 100;
+
+      void clear();
+      void add(const neo::types::button_event& handler);
+
+      int size() const
+      {
+        return handlers.size();
+      }
+
+      // Calls function with every handler firing this frame
+      template<typename Function>
+      void dispatch(Function&& function) const
+      {
+        if (!(neo::input::pressed_keys() & pressed_keys) &&
+            !(neo::input::held_keys() & held_keys) &&
+            !(neo::input::released_keys() & released_keys))
+        {
+          return;
+        }
+
+        for (const neo::types::button_event& handler : handlers)
+        {
+          if (fired(handler))
+          {
+            function(handler);
+          }
+        }
+      }
+
+    private:
+      bn::vector<neo::types::button_event, MAX_HANDLERS> handlers;
+      unsigned pressed_keys = 0;
+      unsigned held_keys = 0;
+      unsigned released_keys = 0;
+  };
 }
 
 #endif
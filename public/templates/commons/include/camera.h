@@ -2,22 +2,95 @@
 #define NEO_CAMERA_H
 
 #include <bn_camera_ptr.h>
+#include <bn_fixed.h>
+#include <bn_vector.h>
 
 #include <neo_types.h>
 
-#include "game.h"
+namespace neo
+{
+  class game;
+}
 
 namespace neo::camera
 {
-  void move_to(
-    neo::game* game,
-    neo::types::scene& active_scene,
-    int x,
-    int y,
-    int duration,
-    bool allow_diagonal,
-    bn::string_view direction_priority
-  );
+  static constexpr int EASING_STEPS = 64; // Samples of each curve, plus the end
+
+  /**
+   * Eased progress of t, both from 0 to 1, read from a ROM table so it
+   * costs two loads and a multiply instead of float math
+   */
+  bn::fixed ease(neo::types::easing easing, bn::fixed t);
+
+  /**
+   * Straight camera movement between two points
+   */
+  struct segment
+  {
+    int from_x;
+    int from_y;
+    int to_x;
+    int to_y;
+    int frames;
+    bn::fixed step; // Progress per frame, 1 / frames
+  };
+
+  /**
+   * Camera movement stepped once per frame by the game
+   */
+  class tween
+  {
+    public:
+      void move_to(
+        neo::game* game,
+        int x,
+        int y,
+        int duration,
+        bool allow_diagonal,
+        bn::string_view direction_priority,
+        neo::types::easing easing = neo::types::easing::LINEAR
+      );
+      void cancel();
+      bool update(); // Returns true on the frame the camera reaches its target
+
+      inline bool active() const { return game != nullptr; }
+
+    private:
+      void add_segment(int from_x, int from_y, int to_x, int to_y, int frames);
+
+      neo::game* game = nullptr;
+      bn::vector<neo::camera::segment, 2> segments;
+      neo::types::easing easing = neo::types::easing::LINEAR;
+      int current = 0;
+      int frame = 0;
+      int end_x = 0;
+      int end_y = 0;
+  };
+
+  /**
+   * Camera tracking the player. It stays still while the player is within
+   * the deadzone around its center, then closes a share of the distance
+   * every frame (all of it with a lerp of 1, the classic locked camera).
+   */
+  class follow
+  {
+    public:
+      void setup(const neo::types::camera_follow& settings);
+      void snap(neo::game* game, int x, int y);
+      void set_target(neo::game* game, int x, int y); // Camera position that centers the player
+      void cancel();
+      void update();
+
+    private:
+      neo::game* game = nullptr;
+      int deadzone_x = 0;
+      int deadzone_y = 0;
+      bn::fixed lerp = 1;
+      int target_x = 0;
+      int target_y = 0;
+      bn::fixed camera_x;
+      bn::fixed camera_y;
+  };
 }
 
 #endif
@@ -0,0 +1,153 @@
+#ifndef NEO_CODE_H
+#define NEO_CODE_H
+
+#include <bn_core.h>
+#include <bn_fixed.h>
+#include <bn_string_view.h>
+
+#include <neo_types.h>
+#include <neo_variables.h>
+
+namespace neo::code
+{
+  // Marks an inline operand where a variable slot could be
+  static constexpr unsigned short IMMEDIATE = 0xFFFF;
+
+  // on-variable-change filter for any new value
+  static constexpr unsigned ANY_CHANGE = 0xFF;
+
+  // if condition nodes: comparisons, then the AND and OR of other nodes.
+  // Must match COMPARISONS, AND and OR in events.ts
+  enum class comparison
+  {
+    EQUAL = 0,
+    NOT_EQUAL = 1,
+    LESS = 2,
+    LESS_EQUAL = 3,
+    GREATER = 4,
+    GREATER_EQUAL = 5,
+    AND = 6,
+    OR = 7
+  };
+
+  /**
+   * Cursor over compiled events, see events.ts for the format. Code is
+   * 16-bit words with inline operands and relative jumps, so a list only
+   * needs its start, size and the position of the next word.
+   */
+  struct reader
+  {
+    const unsigned short* code;
+    int size;
+    int pc;
+
+    reader(const neo::types::event_list& events):
+      code(events.code),
+      size(events.size),
+      pc(0) {}
+
+    inline bool finished() const
+    {
+      return pc >= size;
+    }
+
+    inline const unsigned short* position() const
+    {
+      return code + pc;
+    }
+
+    inline void jump(int offset)
+    {
+      pc += offset;
+    }
+
+    inline unsigned word()
+    {
+      return code[pc++];
+    }
+
+    inline int integer()
+    {
+      unsigned low = word();
+      return (int)(low | (word() << 16));
+    }
+
+    inline bn::fixed fixed()
+    {
+      return bn::fixed::from_data(integer());
+    }
+
+    // Bytes two per word, the first one in the low byte
+    inline const unsigned char* bytes(int& count)
+    {
+      count = word();
+      const unsigned char* data = reinterpret_cast<const unsigned char*>(position());
+      pc += (count + 1) / 2;
+      return data;
+    }
+
+    inline bn::string_view string()
+    {
+      int count;
+      const char* data = reinterpret_cast<const char*>(bytes(count));
+      return bn::string_view(data, count);
+    }
+
+    // A variable read as type, or a constant already converted to it
+    inline int value(
+      const neo::variables::registry& variables,
+      neo::variables::type type = neo::variables::type::INT
+    )
+    {
+      unsigned slot = word();
+
+      if (slot == IMMEDIATE)
+      {
+        return integer();
+      }
+
+      return variables.get(slot, type);
+    }
+
+    // Keys, then the trigger with the every flag in the high byte
+    inline neo::types::button_event buttons()
+    {
+      neo::types::button_event event;
+      event.keys = word();
+
+      unsigned flags = word();
+      event.trigger = (neo::types::button_trigger)(flags & 0xFF);
+      event.every = flags >> 8;
+      return event;
+    }
+
+    // The watched slot, then the comparison the new value must pass and
+    // the int it is compared with, or ANY_CHANGE alone
+    inline neo::types::variable_event watch()
+    {
+      neo::types::variable_event event;
+      event.slot = word();
+
+      unsigned filter = word();
+
+      if (filter != ANY_CHANGE)
+      {
+        event.comparison = filter;
+        event.value = integer();
+      }
+
+      return event;
+    }
+
+    // The code of a jump operand up to its target, as its own list
+    inline neo::types::event_list body()
+    {
+      int count = word();
+      neo::types::event_list events = { position(), count };
+      pc += count;
+      return events;
+    }
+  };
+}
+
+#endif
@@ -11,12 +11,14 @@ namespace neo
     constexpr int DOWN = 0;
   }
 
+  // Walk cycles, starting on a step so it shows right away
   namespace anims
   {
-    constexpr int LEFT [4] = {2, 8, 2, 9};
-    constexpr int RIGHT [4] = {2, 8, 2, 9};
-    constexpr int UP [4] = {1, 6, 1, 7};
-    constexpr int DOWN [4] = {0, 4, 0, 5};
+    constexpr int COUNT = 4;
+    constexpr int LEFT [COUNT] = {8, 2, 9, 2};
+    constexpr int RIGHT [COUNT] = {8, 2, 9, 2};
+    constexpr int UP [COUNT] = {6, 1, 7, 1};
+    constexpr int DOWN [COUNT] = {4, 0, 5, 0};
   }
 }
 
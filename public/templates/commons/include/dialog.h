@@ -2,35 +2,59 @@
 #define NEO_DIALOG_H
 
 #include <bn_core.h>
+#include <bn_optional.h>
 #include <bn_regular_bg_ptr.h>
-#include <bn_sprite_ptr.h>
-#include <bn_vector.h>
+#include <bn_regular_bg_item.h>
+
+#include <neo_types.h>
 
 namespace neo
 {
   class game;
 
+  /**
+   * Textbox revealing its pages a few characters per frame, updated by
+   * the game loop like any other effect. A shows the rest of the page at
+   * once, then turns the page or closes the dialog. B held speeds the
+   * reveal up.
+   */
   class dialog
   {
     static constexpr int LINE_HEIGHT = 8;
     static constexpr int PADDING = 8;
-    static constexpr int MAX_LENGTH = 27;
-    static constexpr int MAX_LINES = 5;
+    static constexpr int MAX_LINES = 3; // Per page, the tallest textbox
+    static constexpr int FAST_FORWARD = 4; // Speed multiplier while B is held
 
     public:
-      dialog(neo::game* game, const bn::vector<bn::string_view, MAX_LINES>& lines);
+      dialog(neo::game* game, const neo::types::dialog_event& event);
 
       void show();
+      bool update(); // Returns true once the dialog has been dismissed
       void hide();
       bn::regular_bg_item get_background();
 
       neo::game* game;
+      const unsigned short* pages; // In the show-dialog event code
+      int pages_count;
       int lines_count;
-      bn::vector<bn::string_view, MAX_LINES> lines;
+      int speed;
       neo::types::direction direction;
 
       bn::regular_bg_item bg_2_lines;
       bn::regular_bg_item bg_3_lines;
+
+    private:
+      void start_page(int index);
+      void reveal_glyphs(int count);
+
+      bn::optional<bn::regular_bg_ptr> bg;
+
+      // Page shown and next glyph of it to reveal, written to game->text
+      // a few per frame
+      int current_page;
+      neo::types::dialog_page page;
+      const unsigned short* next_page;
+      int reveal;
   };
 }
 
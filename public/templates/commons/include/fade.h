@@ -1,12 +1,33 @@
 #ifndef NEO_FADE_H
 #define NEO_FADE_H
 
+#include <bn_optional.h>
 #include <bn_regular_bg_ptr.h>
+#include <bn_blending_actions.h>
 
 namespace neo::fade
 {
-  void enter(bn::regular_bg_ptr& bg, int duration);
-  void exit(bn::regular_bg_ptr& bg, int duration);
+  /**
+   * Background fade stepped once per frame by the game
+   */
+  class transition
+  {
+    public:
+      void enter(bn::regular_bg_ptr& bg, int duration);
+      void exit(bn::regular_bg_ptr& bg, int duration);
+      void cancel();
+      bool update(); // Returns true on the frame the fade finishes
+
+      inline bool active() const { return action.has_value(); }
+      inline bool entering() const { return is_entering; }
+
+    private:
+      void finish();
+
+      bn::regular_bg_ptr* bg = nullptr;
+      bn::optional<bn::blending_fade_alpha_to_action> action;
+      bool is_entering = false;
+  };
 }
 
 #endif
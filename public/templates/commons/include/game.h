@@ -3,6 +3,8 @@
 
 #include <bn_core.h>
 #include <bn_vector.h>
+#include <bn_optional.h>
+#include <bn_random.h>
 #include <bn_camera_actions.h>
 
 #include <neo_types.h>
@@ -12,44 +14,87 @@
 #include "commons.h"
 #include "actor.h"
 #include "sprite.h"
+#include "task.h"
+#include "code.h"
+#include "fade.h"
+#include "camera.h"
+#include "occupancy.h"
+#include "pool.h"
+#include "tile_cache.h"
+#include "dialog.h"
+#include "text_layer.h"
+#include "buttons.h"
+#include "watchers.h"
+#include "scheduler.h"
 
 namespace neo
 {
   class game
   {
     public:
+      static constexpr int MAX_ACTORS = neo::types::MAX_SCENE_ACTORS;
+      static constexpr int MAX_SPRITES = neo::types::MAX_SCENE_SPRITES;
+      static constexpr int MAX_TASKS = 2 * MAX_ACTORS + 32; // Every actor can hold an init task, and an update task for the whole scene
+
       game();
       game(bn::camera_ptr& camera_ptr, neo::player& player);
 
-      bn::string_view current_scene;
+      int current_scene;
       bool scene_changed;
 
       bn::camera_ptr& camera;
       neo::player& player;
       neo::variables::registry variables;
+      bn::random random;
 
-      neo::types::scene* active_scene;
+      const neo::types::scene* active_scene;
+      neo::types::map_metrics map_metrics;
       bn::regular_bg_ptr* scene_bg;
-      neo::types::scene_event* last_goto_event;
+      bn::optional<neo::types::scene_event> last_goto_event;
 
-      int scripted_events_count;
-      bn::vector<neo::types::event*, 100> scripted_events;
+      neo::buttons::dispatcher button_handlers;
+      neo::watchers::dispatcher variable_handlers;
 
       int actors_count;
-      bn::vector<neo::actor*, 20> actors;
+      bn::vector<neo::actor*, MAX_ACTORS> actors;
+      neo::pool<neo::actor, MAX_ACTORS> actors_pool;
+      neo::occupancy_grid occupancy;
+      neo::tile_cache sprite_tiles;
 
       int sprites_count;
-      bn::vector<neo::sprite*, 50> sprites;
+      bn::vector<neo::sprite*, MAX_SPRITES> sprites;
+      neo::pool<neo::sprite, MAX_SPRITES> sprites_pool;
+
+      bn::vector<neo::task, MAX_TASKS> tasks;
+      neo::scheduler jobs;
+      neo::fade::transition fade;
+      neo::camera::tween camera_tween;
+      neo::camera::follow camera_follow;
+      neo::dialog* active_dialog;
+      neo::text_layer text;
+      neo::pool<neo::dialog, 1> dialogs_pool;
+      int music_fade_volume; // -1 when music is not fading out
 
+      void set_scene(int scene_id);
       void set_scene(bn::string_view scene_name);
-      void exec_event(const neo::types::event* e, bool is_loop);
+      void spawn_actor(int index);
+      void spawn_sprite(int index);
+      void start_task(const neo::types::event_list& events, bool in_loop, bool repeat = false);
+      bool exec_event(neo::code::reader& code, neo::task& task);
       void run();
+      void load_map_metrics();
+      void update_tasks();
+      void step_task(neo::task& task);
+      bool is_waiting(neo::task& task);
+      bool has_blocking_tasks();
+      void update_effects();
+      void stop_effects();
       void enable_blending();
       void disable_blending();
       bool has_collision(int tile_x, int tile_y);
       neo::actor* get_actor_at(int tile_x, int tile_y, neo::types::direction direction);
-      bool evaluate_condition(neo::types::if_condition* condition);
-      bn::string_view get_expression_value(neo::types::if_expression* expression);
+      bool evaluate_condition(neo::code::reader& code);
+      int update_variable(neo::types::event_type type, neo::code::reader& code);
   };
 }
 
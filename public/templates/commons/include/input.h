@@ -0,0 +1,49 @@
+#ifndef NEO_INPUT_H
+#define NEO_INPUT_H
+
+#include <bn_core.h>
+
+/**
+ * Keypad state of the current frame. Everything in the runtime reads keys
+ * from here instead of bn::keypad, so a build can record the session
+ * (NEO_INPUT_RECORD, logged as "[input] <frame> <keys>" on every change)
+ * or replay one frame-exactly (NEO_INPUT_REPLAY, from neo_replay.h).
+ */
+namespace neo::input
+{
+  // Same bits as the GBA KEYINPUT register
+  enum key : unsigned
+  {
+    A = 1 << 0,
+    B = 1 << 1,
+    SELECT = 1 << 2,
+    START = 1 << 3,
+    RIGHT = 1 << 4,
+    LEFT = 1 << 5,
+    UP = 1 << 6,
+    DOWN = 1 << 7,
+    R = 1 << 8,
+    L = 1 << 9
+  };
+
+  // Keys held from a given frame on, replay streams are sorted by frame
+  struct change
+  {
+    int frame;
+    unsigned keys;
+  };
+
+  void update(); // Call right after every bn::core::update
+  int frame();
+
+  unsigned held_keys();
+  unsigned previous_keys(); // Held the frame before
+  unsigned pressed_keys();
+  unsigned released_keys();
+
+  inline bool held(unsigned keys) { return (held_keys() & keys) != 0; }
+  inline bool pressed(unsigned keys) { return (pressed_keys() & keys) != 0; }
+  inline bool released(unsigned keys) { return (released_keys() & keys) != 0; }
+}
+
+#endif
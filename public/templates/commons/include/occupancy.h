@@ -0,0 +1,36 @@
+#ifndef NEO_OCCUPANCY_H
+#define NEO_OCCUPANCY_H
+
+namespace neo
+{
+  class actor;
+
+  /**
+   * Hashed cell grid of the tiles taken by actors. Each bucket is an
+   * intrusive list threaded through the actors, so the memory does not
+   * depend on the map size and queries don't depend on the actors count.
+   */
+  class occupancy_grid
+  {
+    public:
+      static constexpr int BUCKETS = 128; // Must be a power of two
+
+      occupancy_grid();
+
+      void clear();
+      void add(neo::actor* actor, int tile_x, int tile_y);
+      void remove(neo::actor* actor);
+      void move(neo::actor* actor, int tile_x, int tile_y);
+      neo::actor* at(int tile_x, int tile_y) const;
+
+    private:
+      static inline int bucket(int tile_x, int tile_y)
+      {
+        return ((tile_y << 4) ^ tile_x) & (BUCKETS - 1);
+      }
+
+      neo::actor* buckets[BUCKETS];
+  };
+}
+
+#endif
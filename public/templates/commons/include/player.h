@@ -2,13 +2,15 @@
 #define NEO_PLAYER_H
 
 #include <bn_core.h>
+#include <bn_optional.h>
+#include <bn_vector.h>
 #include <bn_sprite_ptr.h>
 #include <bn_camera_actions.h>
-#include <bn_sprite_animate_actions.h>
 #include <bn_sprite_item.h>
 
 #include "neo_types.h"
 #include "commons.h"
+#include "tile_cache.h"
 
 namespace neo
 {
@@ -21,13 +23,20 @@ namespace neo
 
       inline constexpr static int ANIMATION_FPS = 7; // slow: 12, faster: 7
       inline constexpr static int PLAYER_SPEED = 2; // slow: 1, faster: 2
+      inline constexpr static int MAX_SENSORS = 8; // Overlapping sensors tracked at once
 
       void set_game(neo::game& game);
-      void set_map(neo::types::map& map);
+      void set_map(const neo::types::map& map);
       void set_position(bn::fixed_point position);
-      void play(neo::types::map& map, int start_x, int start_y, int start_z, neo::types::direction start_direction, bn::sprite_ptr sprite_, bn::sprite_tiles_item tiles_);
+      void play(const neo::types::map& map, int start_x, int start_y, int start_z, neo::types::direction start_direction, bn::sprite_ptr sprite_, bn::sprite_tiles_item tiles_);
       void update();
-      void move(bn::sprite_animate_action<4>& action);
+      void walk();
+      void move();
+      void stop();
+      bool direction_held();
+      void face(neo::types::direction direction);
+      void update_sensors(int tile_x, int tile_y, bool trigger);
+      inline bool is_moving() const { return moving; }
       int width();
       int height();
       neo::types::direction opposite_direction();
@@ -38,7 +47,17 @@ namespace neo
       neo::types::direction direction;
 
       neo::game* game;
-      neo::types::map* map;
+      const neo::types::map* map;
+
+      // Walking state, a step across one tile spans several frames
+      neo::animation animation;
+      bool moving;
+      int move_delta;
+      int target_tile_x;
+      int target_tile_y;
+
+      // Sensors covering the current tile, to run exit events on leaving
+      bn::vector<const neo::types::sensor*, MAX_SENSORS> active_sensors;
   };
 }
 
@@ -0,0 +1,117 @@
+#ifndef NEO_POOL_H
+#define NEO_POOL_H
+
+#include <new>
+#include <utility>
+
+#include <bn_core.h>
+#include <bn_log.h>
+#include <bn_assert.h>
+
+namespace neo
+{
+  /**
+   * Fixed capacity storage for objects living as long as a scene, so scene
+   * changes don't go through the heap. The most objects ever alive at once
+   * is kept to check the generated capacities against real projects.
+   */
+  template<typename Type, int MaxSize>
+  class pool
+  {
+    static_assert(MaxSize > 0, "Pool capacity must be positive");
+
+    public:
+      pool():
+        count(0),
+        high_water_mark(0)
+      {
+        for (int i = 0; i < MaxSize; ++i)
+        {
+          alive[i] = false;
+          free_slots[i] = MaxSize - 1 - i;
+        }
+      }
+
+      ~pool()
+      {
+        clear();
+      }
+
+      pool(const pool&) = delete;
+      pool& operator=(const pool&) = delete;
+
+      template<typename... Args>
+      Type* create(Args&&... args)
+      {
+        if (count >= MaxSize)
+        {
+          BN_LOG("Pool is full, capacity: ", MaxSize);
+          return nullptr;
+        }
+
+        int index = free_slots[MaxSize - 1 - count];
+        Type* object = new (slot(index)) Type(std::forward<Args>(args)...);
+        alive[index] = true;
+        ++count;
+
+        if (count > high_water_mark)
+        {
+          high_water_mark = count;
+        }
+
+        return object;
+      }
+
+      void destroy(Type* object)
+      {
+        if (object == nullptr)
+        {
+          return;
+        }
+
+        int index = (reinterpret_cast<unsigned char*>(object) - storage) / int(sizeof(Type));
+        BN_ASSERT(index >= 0 && index < MaxSize && alive[index], "Object not owned by this pool");
+
+        object->~Type();
+        alive[index] = false;
+        --count;
+        free_slots[MaxSize - 1 - count] = index;
+      }
+
+      // Destroys every live object at once, on scene changes
+      void clear()
+      {
+        for (int i = 0; i < MaxSize; ++i)
+        {
+          if (alive[i])
+          {
+            slot(i)->~Type();
+            alive[i] = false;
+          }
+
+          free_slots[i] = MaxSize - 1 - i;
+        }
+
+        count = 0;
+      }
+
+      inline int size() const { return count; }
+      inline int max_size() const { return MaxSize; }
+      inline bool full() const { return count == MaxSize; }
+      inline int high_water() const { return high_water_mark; }
+
+    private:
+      inline Type* slot(int index)
+      {
+        return reinterpret_cast<Type*>(storage + index * int(sizeof(Type)));
+      }
+
+      alignas(Type) unsigned char storage[MaxSize * sizeof(Type)];
+      bool alive[MaxSize];
+      int free_slots[MaxSize]; // Stack of free indexes, the top is at MaxSize - 1 - count
+      int count;
+      int high_water_mark;
+  };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef NEO_SCHEDULER_H
+#define NEO_SCHEDULER_H
+
+#include <bn_core.h>
+#include <bn_fixed.h>
+
+#include <neo_types.h>
+
+namespace neo
+{
+  /**
+   * Work that doesn't have to happen in the frame it is asked for, like
+   * spawning the entities of a scene. Context is usually the game.
+   */
+  struct job
+  {
+    void (*run)(void* context, int argument);
+    void* context;
+    int argument;
+    bool blocking; // Holds the player and button handlers until it ran
+  };
+
+  /**
+   * First in, first out queue of jobs drained at the end of each frame
+   * until the CPU usage of the frame, as bn::core::current_cpu_usage
+   * reports it, reaches the budget. At least one job runs per frame so
+   * jobs costing more than a whole budget still go through.
+   */
+  class scheduler
+  {
+    public:
+      // Setup of the largest scene (its actors, sprites and events) and
+      // room for other deferred work
+      static constexpr int MAX_JOBS = neo::types::MAX_SCENE_ACTORS + neo::types::MAX_SCENE_SPRITES + 1 + 32;
+
+      // Share of the frame jobs may fill, the rest is left for Butano's
+      // own update and the vblank work it triggers
+      static constexpr bn::fixed FRAME_BUDGET = bn::fixed(0.75);
+
+      scheduler():
+        head(0),
+        count(0),
+        blocking_count(0) {}
+
+      void clear();
+      bool push(const neo::job& job);
+
+      // Runs jobs until the frame reached budget or none is left,
+      // returns how many ran
+      int drain(bn::fixed budget = FRAME_BUDGET);
+
+      bool empty() const
+      {
+        return count == 0;
+      }
+
+      int size() const
+      {
+        return count;
+      }
+
+      bool has_blocking() const
+      {
+        return blocking_count > 0;
+      }
+
+    private:
+      neo::job jobs[MAX_JOBS];
+      int head;
+      int count;
+      int blocking_count;
+  };
+}
+
+#endif
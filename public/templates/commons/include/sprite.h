@@ -13,7 +13,7 @@ namespace neo
   class sprite
   {
     public:
-      sprite(neo::game* game, neo::types::sprite* sprite_definition);
+      sprite(neo::game* game, const neo::types::sprite* sprite_definition);
       ~sprite(); // Destructor - called automatically when delete is used
 
       void set_position(int tile_x, int tile_y);
@@ -21,7 +21,7 @@ namespace neo
       void enable();
 
       neo::game* game;
-      neo::types::sprite* definition;
+      const neo::types::sprite* definition;
       bn::sprite_ptr inner_sprite;
       bn::fixed_point position;
   };
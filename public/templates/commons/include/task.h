@@ -0,0 +1,87 @@
+#ifndef NEO_TASK_H
+#define NEO_TASK_H
+
+#include <bn_core.h>
+#include <bn_vector.h>
+#include <bn_log.h>
+
+#include <neo_types.h>
+
+#include "code.h"
+
+namespace neo
+{
+  /**
+   * What a task is waiting for before its next event runs
+   */
+  enum class task_wait
+  {
+    NONE,
+    FRAMES,
+    BUTTON,
+    FADE,
+    DIALOG,
+    CAMERA,
+    MUSIC
+  };
+
+  /**
+   * A resumable list of events, stepped once per frame by the game.
+   * if branches and button handlers are jumps in the same code, scripts
+   * push a frame instead of recursing, so any event can suspend the whole
+   * task.
+   */
+  struct task
+  {
+    static constexpr int MAX_DEPTH = 6;
+
+    bn::vector<neo::code::reader, MAX_DEPTH> frames;
+    neo::types::event_list root;
+    bool in_loop; // Started from the game loop, on-button-press runs instead of registering
+    bool repeat; // Restarts every frame instead of finishing (actor update events)
+
+    neo::task_wait wait;
+    int wait_frames;
+    neo::types::button_event wait_buttons;
+
+    task(const neo::types::event_list& events_, bool in_loop_, bool repeat_):
+      root(events_),
+      in_loop(in_loop_),
+      repeat(repeat_),
+      wait(neo::task_wait::NONE),
+      wait_frames(0)
+    {
+      restart();
+    }
+
+    inline void restart()
+    {
+      frames.clear();
+      frames.push_back(neo::code::reader(root));
+    }
+
+    inline bool push(const neo::types::event_list& events_)
+    {
+      if (events_.empty())
+      {
+        return true;
+      }
+
+      if (frames.full())
+      {
+        BN_LOG("Task frame stack is full, skipping nested events");
+        return false;
+      }
+
+      frames.push_back(neo::code::reader(events_));
+      return true;
+    }
+
+    inline bool finished() const
+    {
+      return frames.empty();
+    }
+  };
+}
+
+#endif
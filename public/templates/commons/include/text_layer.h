@@ -0,0 +1,41 @@
+#ifndef NEO_TEXT_LAYER_H
+#define NEO_TEXT_LAYER_H
+
+#include <bn_core.h>
+#include <bn_optional.h>
+#include <bn_regular_bg_ptr.h>
+#include <bn_regular_bg_map_ptr.h>
+
+namespace neo
+{
+  /**
+   * Text drawn as the tiles of a dedicated regular BG instead of sprites,
+   * so it takes no OAM entries. The font tiles and the map are loaded to
+   * VRAM the first time the layer is shown and kept afterwards, writing
+   * or erasing a character is a single map cell write.
+   */
+  class text_layer
+  {
+    public:
+      static constexpr int COLUMNS = 32;
+      static constexpr int ROWS = 32;
+      static constexpr int GLYPH_SIZE = 8;
+
+      void show(int x, int y, int priority); // Top left corner, in screen pixels
+      void hide();
+      void clear();
+      void put(int column, int row, int glyph); // Font tile, 0 is blank
+
+    private:
+      void load();
+
+      bn::optional<bn::regular_bg_map_ptr> map;
+      bn::optional<bn::regular_bg_ptr> bg;
+
+      // Cells written since the last clear, the rest stays blank
+      int used_columns = 0;
+      int used_rows = 0;
+  };
+}
+
+#endif
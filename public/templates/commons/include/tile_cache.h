@@ -0,0 +1,90 @@
+#ifndef NEO_TILE_CACHE_H
+#define NEO_TILE_CACHE_H
+
+#include <bn_core.h>
+#include <bn_vector.h>
+#include <bn_optional.h>
+#include <bn_sprite_tiles_ptr.h>
+#include <bn_sprite_tiles_item.h>
+
+namespace neo
+{
+  /**
+   * Tiles of the sprite items in use, created once per graphics index and
+   * shared by every sprite of the same item. Turning and walking swap
+   * handles instead of going through the VRAM allocator each time.
+   */
+  class tile_cache
+  {
+    public:
+      static constexpr int MAX_ITEMS = 16;
+      static constexpr int MAX_GRAPHICS = 10; // Standing and walking frames of every direction
+
+      bn::sprite_tiles_ptr get(const bn::sprite_tiles_item& item, int graphics_index);
+      void clear();
+
+    private:
+      struct entry
+      {
+        bn::sprite_tiles_item item;
+        bn::optional<bn::sprite_tiles_ptr> graphics[MAX_GRAPHICS];
+      };
+
+      bn::vector<entry, MAX_ITEMS> entries;
+  };
+
+  /**
+   * Loops over graphics indexes like bn::sprite_animate_action, but leaves
+   * creating the tiles to the caller so they can come from the cache
+   */
+  struct animation
+  {
+    const int* frames = nullptr;
+    int frames_count = 0;
+    int wait_updates = 0;
+    int index = 0;
+    int counter = 0;
+
+    inline void start(const int* frames_, int frames_count_, int wait_updates_)
+    {
+      frames = frames_;
+      frames_count = frames_count_;
+      wait_updates = wait_updates_;
+      index = 0;
+      counter = 0;
+    }
+
+    inline void stop()
+    {
+      frames = nullptr;
+    }
+
+    inline bool active() const
+    {
+      return frames != nullptr;
+    }
+
+    // Returns the graphics index to show on this update, or -1 if it doesn't change
+    inline int update()
+    {
+      if (!active())
+      {
+        return -1;
+      }
+
+      if (counter > 0)
+      {
+        --counter;
+        return -1;
+      }
+
+      counter = wait_updates;
+      int graphics_index = frames[index];
+      index = (index + 1) % frames_count;
+
+      return graphics_index;
+    }
+  };
+}
+
+#endif
@@ -1,9 +0,0 @@
-#ifndef NEO_UTILS_H
-#define NEO_UTILS_H
-
-namespace neo::utils
-{
-  void wait(int milliseconds);
-}
-
-#endif
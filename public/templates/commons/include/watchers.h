@@ -0,0 +1,57 @@
+#ifndef NEO_WATCHERS_H
+#define NEO_WATCHERS_H
+
+#include <bn_core.h>
+#include <bn_vector.h>
+
+#include <neo_types.h>
+#include <neo_variables.h>
+
+namespace neo::watchers
+{
+  // Whether the new value of a variable passes the handler's filter
+  bool passes(const neo::types::variable_event& handler, int value);
+
+  /**
+   * on-variable-change handlers of the running scene, registered once when
+   * the events reach them. They are only looked at on the frames a set
+   * changes a variable, and only when some handler watches it.
+   */
+  class dispatcher
+  {
+    public:
+      static constexpr int MAX_HANDLERS = 32;
+
+      void clear();
+      void add(const neo::types::variable_event& handler);
+
+      int size() const
+      {
+        return handlers.size();
+      }
+
+      // Calls function with every handler of slot the new value passes
+      template<typename Function>
+      void dispatch(int slot, int value, Function&& function) const
+      {
+        if (!watched[slot])
+        {
+          return;
+        }
+
+        for (const neo::types::variable_event& handler : handlers)
+        {
+          if (handler.slot == slot && passes(handler, value))
+          {
+            function(handler);
+          }
+        }
+      }
+
+    private:
+      bn::vector<neo::types::variable_event, MAX_HANDLERS> handlers;
+      bool watched[neo::variables::COUNT > 0 ? neo::variables::COUNT : 1] = {};
+  };
+}
+
+#endif
@@ -10,11 +10,15 @@ namespace neo
 {
   actor::actor(
     neo::game* game_,
-    neo::types::actor* actor_definition_
+    const neo::types::actor* actor_definition_
   ) : game(game_),
       definition(actor_definition_),
       sprite(definition->sprite.create_sprite(0, 0)),
-      position(0, 0)
+      position(0, 0),
+      next_in_cell(nullptr),
+      cell_x(0),
+      cell_y(0),
+      occupying(false)
   {
     sprite.set_camera(game->camera);
     sprite.set_visible(true);
@@ -27,6 +31,7 @@ namespace neo
 
   actor::~actor()
   {
+    game->occupancy.remove(this);
     sprite.set_visible(false);
   }
 
@@ -41,21 +46,21 @@ namespace neo
 
     if (direction == neo::types::direction::LEFT)
     {
-      sprite.set_tiles(definition->sprite.tiles_item().create_tiles(neo::tileindex::LEFT));
+      sprite.set_tiles(game->sprite_tiles.get(definition->sprite.tiles_item(), neo::tileindex::LEFT));
       sprite.set_horizontal_flip(true);
     }
     else if (direction == neo::types::direction::RIGHT)
     {
-      sprite.set_tiles(definition->sprite.tiles_item().create_tiles(neo::tileindex::RIGHT));
+      sprite.set_tiles(game->sprite_tiles.get(definition->sprite.tiles_item(), neo::tileindex::RIGHT));
       sprite.set_horizontal_flip(false);
     }
     else if (direction == neo::types::direction::UP)
     {
-      sprite.set_tiles(definition->sprite.tiles_item().create_tiles(neo::tileindex::UP));
+      sprite.set_tiles(game->sprite_tiles.get(definition->sprite.tiles_item(), neo::tileindex::UP));
     }
     else
     {
-      sprite.set_tiles(definition->sprite.tiles_item().create_tiles(neo::tileindex::DOWN));
+      sprite.set_tiles(game->sprite_tiles.get(definition->sprite.tiles_item(), neo::tileindex::DOWN));
     }
   }
 
@@ -67,12 +72,14 @@ namespace neo
     }
 
     position = bn::fixed_point(tile_x, tile_y);
+    game->occupancy.move(this, tile_x, tile_y);
 
-    int x = game->active_scene->map_data->to_pixel_x(game->variables, tile_x)
-        - game->active_scene->map_data->pixel_width(game->variables) / 2
+    const neo::types::map_metrics& metrics = game->map_metrics;
+    int x = metrics.to_pixel(tile_x)
+        - metrics.half_pixel_width
         + sprite.dimensions().width() / 2;
-    int y = game->active_scene->map_data->to_pixel_y(game->variables, tile_y)
-        - game->active_scene->map_data->pixel_height(game->variables) / 2
+    int y = metrics.to_pixel(tile_y)
+        - metrics.half_pixel_height
         + sprite.dimensions().height() / 2;
 
     sprite.set_x(x);
@@ -94,27 +101,21 @@ namespace neo
   {
     sprite.set_visible(false);
     sprite.remove_camera();
+    game->occupancy.remove(this);
   }
 
   void actor::enable()
   {
     sprite.set_visible(true);
     sprite.set_camera(game->camera);
+    game->occupancy.add(this, position.x().right_shift_integer(), position.y().right_shift_integer());
   }
 
   void actor::init()
   {
-    for (int i = 0; i < definition->init_events_count; ++i)
-    {
-      game->exec_event(definition->init_events[i], false);
-    }
-  }
+    game->start_task(definition->init_events, false);
 
-  void actor::update()
-  {
-    for (int i = 0; i < definition->update_events_count; ++i)
-    {
-      game->exec_event(definition->update_events[i], true);
-    }
+    // Update events restart every frame for as long as the scene runs
+    game->start_task(definition->update_events, true, true);
   }
 }
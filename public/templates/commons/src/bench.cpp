@@ -0,0 +1,70 @@
+#ifdef NEO_BENCH_FRAMES
+
+#define BN_CFG_LOG_ENABLED true
+
+#include <bn_core.h>
+#include <bn_log.h>
+#include <bn_fixed.h>
+#include <bn_string_view.h>
+
+#include "bench.h"
+
+namespace neo::bench
+{
+  namespace
+  {
+    constexpr int MAX_SCENES = 64;
+
+    struct frame_sample
+    {
+      int cpu; // bn::fixed data, 4096 is a full frame
+      int scene_id;
+    };
+
+    BN_DATA_EWRAM frame_sample samples[NEO_BENCH_FRAMES];
+    BN_DATA_EWRAM bn::string_view scene_names[MAX_SCENES];
+    int samples_count = 0;
+    bool reported = false;
+
+    void report()
+    {
+      for (int i = 0; i < MAX_SCENES; ++i)
+      {
+        if (!scene_names[i].empty())
+        {
+          BN_LOG("[bench] scene ", i, " ", scene_names[i]);
+        }
+      }
+
+      for (int i = 0; i < samples_count; ++i)
+      {
+        BN_LOG("[bench] frame ", i, " ", samples[i].cpu, " ", samples[i].scene_id);
+      }
+
+      BN_LOG("[bench] done");
+      reported = true;
+    }
+  }
+
+  void sample(int scene_id, bn::string_view scene_name)
+  {
+    if (reported)
+    {
+      return;
+    }
+
+    if (scene_id >= 0 && scene_id < MAX_SCENES && scene_names[scene_id].empty())
+    {
+      scene_names[scene_id] = scene_name;
+    }
+
+    samples[samples_count++] = { bn::core::last_cpu_usage().data(), scene_id };
+
+    if (samples_count == NEO_BENCH_FRAMES)
+    {
+      report();
+    }
+  }
+}
+
+#endif
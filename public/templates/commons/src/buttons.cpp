@@ -1,40 +1,73 @@
 #include <bn_core.h>
-#include <bn_keypad.h>
-#include <bn_vector.h>
-#include <bn_string_view.h>
+#include <bn_log.h>
+
+#include "buttons.h"
+#include "input.h"
 
 namespace neo::buttons
 {
-  bool is_pressed(bn::string_view button)
+  bool fired(unsigned keys, neo::types::button_trigger trigger, bool every)
   {
-    if (button == "Start") return bn::keypad::start_pressed();
-    if (button == "Select") return bn::keypad::select_pressed();
-    if (button == "A") return bn::keypad::a_pressed();
-    if (button == "B") return bn::keypad::b_pressed();
-    if (button == "Up") return bn::keypad::up_pressed();
-    if (button == "Down") return bn::keypad::down_pressed();
-    if (button == "Left") return bn::keypad::left_pressed();
-    if (button == "Right") return bn::keypad::right_pressed();
-    if (button == "L") return bn::keypad::l_pressed();
-    if (button == "R") return bn::keypad::r_pressed();
-    return false;
-  }
+    const unsigned held = neo::input::held_keys() & keys;
 
-  bool any_pressed(const bn::vector<bn::string_view, 10>& buttons)
-  {
-    for (const bn::string_view& button : buttons)
+    switch (trigger)
     {
-      if (is_pressed(button)) return true;
+      case neo::types::button_trigger::HELD:
+        return every ? keys != 0 && held == keys : held != 0;
+
+      case neo::types::button_trigger::RELEASED:
+      {
+        const unsigned released = neo::input::released_keys() & keys;
+        return every ? released != 0 && (neo::input::previous_keys() & keys) == keys : released != 0;
+      }
+
+      default:
+      {
+        const unsigned pressed = neo::input::pressed_keys() & keys;
+        return every ? pressed != 0 && held == keys : pressed != 0;
+      }
     }
-    return false;
   }
 
-  bool all_pressed(const bn::vector<bn::string_view, 10>& buttons)
+  void dispatcher::clear()
+  {
+    handlers.clear();
+    pressed_keys = 0;
+    held_keys = 0;
+    released_keys = 0;
+  }
+
+  void dispatcher::add(const neo::types::button_event& handler)
   {
-    for (const bn::string_view& button : buttons)
+    // Lists that run again (scripts, repeated scene events) reach the
+    // same handler more than once, it is only registered the first time
+    for (const neo::types::button_event& other : handlers)
+    {
+      if (other.events.code == handler.events.code)
+      {
+        return;
+      }
+    }
+
+    if (handlers.full())
+    {
+      BN_LOG("Too many button handlers, ignoring one");
+      return;
+    }
+
+    handlers.push_back(handler);
+
+    switch (handler.trigger)
     {
-      if (!is_pressed(button)) return false;
+      case neo::types::button_trigger::HELD:
+        held_keys |= handler.keys;
+        break;
+      case neo::types::button_trigger::RELEASED:
+        released_keys |= handler.keys;
+        break;
+      default:
+        pressed_keys |= handler.keys;
+        break;
     }
-    return true;
   }
 }
@@ -3,105 +3,284 @@
 #include <bn_core.h>
 #include <bn_camera_ptr.h>
 #include <bn_log.h>
+#include <bn_math.h>
 
 #include <neo_types.h>
 
+#include "camera.h"
 #include "game.h"
 
 namespace neo::camera
 {
-  void move_to(
-    neo::game* game,
-    neo::types::scene& active_scene,
+  namespace
+  {
+    constexpr int EASINGS_COUNT = 5;
+    constexpr int ONE = 4096; // bn::fixed data of 1
+
+    // Curves in bn::fixed data, integer math only so it is built by the
+    // compiler and lands in ROM
+    constexpr int curve(neo::types::easing easing, int t)
+    {
+      const int rest = ONE - t;
+
+      switch (easing)
+      {
+        case neo::types::easing::EASE_IN:
+          return t * t / ONE;
+        case neo::types::easing::EASE_OUT:
+          return ONE - rest * rest / ONE;
+        case neo::types::easing::EASE_IN_OUT:
+          return t < ONE / 2 ? 2 * t * t / ONE : ONE - 2 * rest * rest / ONE;
+        case neo::types::easing::SMOOTHSTEP:
+          return (t * t / ONE) * (3 * ONE - 2 * t) / ONE;
+        default:
+          return t;
+      }
+    }
+
+    struct easing_table
+    {
+      int values[EASINGS_COUNT][EASING_STEPS + 1];
+    };
+
+    constexpr easing_table make_easing_table()
+    {
+      easing_table table = {};
+
+      for (int easing = 0; easing < EASINGS_COUNT; ++easing)
+      {
+        for (int step = 0; step <= EASING_STEPS; ++step)
+        {
+          table.values[easing][step] = curve(neo::types::easing(easing), step * ONE / EASING_STEPS);
+        }
+      }
+
+      return table;
+    }
+
+    constexpr easing_table EASING_TABLE = make_easing_table();
+  }
+
+  bn::fixed ease(neo::types::easing easing, bn::fixed t)
+  {
+    if (t <= 0)
+    {
+      return 0;
+    }
+
+    const int position = t.data() * EASING_STEPS;
+    const int index = position / ONE;
+
+    if (index >= EASING_STEPS)
+    {
+      return 1;
+    }
+
+    // Linear between the two closest samples
+    const int* values = EASING_TABLE.values[int(easing)];
+    const int fraction = position % ONE;
+
+    return bn::fixed::from_data(values[index] + (values[index + 1] - values[index]) * fraction / ONE);
+  }
+
+  void tween::move_to(
+    neo::game* game_,
     int x,
     int y,
     int duration,
     bool allow_diagonal,
-    bn::string_view direction_priority
+    bn::string_view direction_priority,
+    neo::types::easing easing_
   )
   {
-    int min_x = -(active_scene.map_data->pixel_width(game->variables) / 2 - neo::types::SCREEN_WIDTH / 2);
-    int max_x = active_scene.map_data->pixel_width(game->variables) / 2 - neo::types::SCREEN_WIDTH / 2;
-    int min_y = -(active_scene.map_data->pixel_height(game->variables) / 2 - neo::types::SCREEN_HEIGHT / 2);
-    int max_y = active_scene.map_data->pixel_height(game->variables) / 2 - neo::types::SCREEN_HEIGHT / 2;
+    const neo::types::map_metrics& metrics = game_->map_metrics;
 
     // 0,0 is camera center
-    int start_x = (int)game->camera.x();
-    int start_y = (int)game->camera.y();
-    int target_x = min_x + active_scene.map_data->to_pixel_x(game->variables, x);
-    int target_y = min_y + active_scene.map_data->to_pixel_y(game->variables, y);
+    int start_x = (int)game_->camera.x();
+    int start_y = (int)game_->camera.y();
+    int target_x = metrics.camera_min_x + metrics.to_pixel(x);
+    int target_y = metrics.camera_min_y + metrics.to_pixel(y);
 
-    int end_x = bn::min(bn::max(target_x, min_x), max_x);
-    int end_y = bn::min(bn::max(target_y, min_y), max_y);
+    end_x = metrics.clamp_camera_x(target_x);
+    end_y = metrics.clamp_camera_y(target_y);
 
-    if (duration <= 0)
-    {
-      game->camera.set_position(end_x, end_y);
-      return;
-    }
+    segments.clear();
+    easing = easing_;
+    current = 0;
+    frame = 0;
+    game = nullptr;
 
-    int delta_x = end_x - start_x;
-    int delta_y = end_y - start_y;
+    // The tween owns the camera until it is done
+    game_->camera_follow.cancel();
 
+    int delta_x = bn::abs(end_x - start_x);
+    int delta_y = bn::abs(end_y - start_y);
     int frames = duration / 16; // Assuming 60 FPS, 16ms per frame
 
+    if (frames <= 0 || delta_x + delta_y == 0)
+    {
+      game_->camera.set_position(end_x, end_y);
+      return;
+    }
+
     if (allow_diagonal)
     {
-      for (int frame = 0; frame <= frames; ++frame)
+      add_segment(start_x, start_y, end_x, end_y, frames);
+    }
+    else
+    {
+      int horizontal_frames = frames * delta_x / (delta_x + delta_y);
+      int vertical_frames = frames - horizontal_frames;
+
+      if (direction_priority == "horizontal")
       {
-        float t = static_cast<float>(frame) / frames;
+        // Move horizontally first, then vertically
+        add_segment(start_x, start_y, end_x, start_y, horizontal_frames);
+        add_segment(end_x, start_y, end_x, end_y, vertical_frames);
+      }
+      else if (direction_priority == "vertical")
+      {
+        // Move vertically first, then horizontally
+        add_segment(start_x, start_y, start_x, end_y, vertical_frames);
+        add_segment(start_x, end_y, end_x, end_y, horizontal_frames);
+      }
+    }
 
-        int new_x = start_x + static_cast<int>(delta_x * t);
-        int new_y = start_y + static_cast<int>(delta_y * t);
+    if (segments.empty())
+    {
+      game_->camera.set_position(end_x, end_y);
+      return;
+    }
 
-        game->camera.set_position(new_x, new_y);
+    game = game_;
+  }
 
-        bn::core::update();
-      }
+  void tween::add_segment(int from_x, int from_y, int to_x, int to_y, int frames)
+  {
+    // Nothing to animate, the next segment starts from its end anyway
+    if (frames <= 0 || (from_x == to_x && from_y == to_y))
+    {
+      return;
     }
-    else
+
+    segments.push_back({ from_x, from_y, to_x, to_y, frames, bn::fixed(1) / frames });
+  }
+
+  void tween::cancel()
+  {
+    segments.clear();
+    game = nullptr;
+  }
+
+  bool tween::update()
+  {
+    if (game == nullptr)
     {
-      int horizontal_frames = frames * abs(delta_x) / (abs(delta_x) + abs(delta_y));
-      int vertical_frames = frames - horizontal_frames;
+      return false;
+    }
 
-      if (direction_priority == "horizontal")
+    if (current < segments.size())
+    {
+      const neo::camera::segment& s = segments[current];
+
+      if (++frame >= s.frames)
       {
-        // Move horizontally first
-        for (int frame = 0; frame <= horizontal_frames; ++frame)
-        {
-          float t = static_cast<float>(frame) / horizontal_frames;
-          int new_x = start_x + static_cast<int>(delta_x * t);
-          game->camera.set_position(new_x, start_y);
-          bn::core::update();
-        }
-        // Then move vertically
-        for (int frame = 0; frame <= vertical_frames; ++frame)
-        {
-          float t = static_cast<float>(frame) / vertical_frames;
-          int new_y = start_y + static_cast<int>(delta_y * t);
-          game->camera.set_position(end_x, new_y);
-          bn::core::update();
-        }
-      } else if (direction_priority == "vertical") {
-        // Move vertically first
-        for (int frame = 0; frame <= vertical_frames; ++frame)
-        {
-          float t = static_cast<float>(frame) / vertical_frames;
-          int new_y = start_y + static_cast<int>(delta_y * t);
-          game->camera.set_position(start_x, new_y);
-          bn::core::update();
-        }
-        // Then move horizontally
-        for (int frame = 0; frame <= horizontal_frames; ++frame)
-        {
-          float t = static_cast<float>(frame) / horizontal_frames;
-          int new_x = start_x + static_cast<int>(delta_x * t);
-          game->camera.set_position(new_x, end_y);
-          bn::core::update();
-        }
+        game->camera.set_position(s.to_x, s.to_y);
+        frame = 0;
+        ++current;
+
+        return false;
       }
+
+      bn::fixed t = ease(easing, s.step * frame);
+
+      game->camera.set_position(
+        s.from_x + ((s.to_x - s.from_x) * t).round_integer(),
+        s.from_y + ((s.to_y - s.from_y) * t).round_integer()
+      );
+
+      return false;
     }
 
     game->camera.set_position(end_x, end_y);
+    game = nullptr;
+
+    return true;
+  }
+
+  void follow::setup(const neo::types::camera_follow& settings)
+  {
+    deadzone_x = bn::max(settings.deadzone_x, 0);
+    deadzone_y = bn::max(settings.deadzone_y, 0);
+    lerp = bn::fixed(bn::min(bn::max(settings.lerp, 1), 100)) / 100;
+  }
+
+  void follow::snap(neo::game* game_, int x, int y)
+  {
+    const neo::types::map_metrics& metrics = game_->map_metrics;
+
+    game = game_;
+    target_x = metrics.clamp_camera_x(x);
+    target_y = metrics.clamp_camera_y(y);
+    camera_x = target_x;
+    camera_y = target_y;
+
+    game->camera.set_position(target_x, target_y);
+  }
+
+  void follow::set_target(neo::game* game_, int x, int y)
+  {
+    const neo::types::map_metrics& metrics = game_->map_metrics;
+
+    // Resuming after a tween, start from wherever it left the camera
+    if (game == nullptr)
+    {
+      game = game_;
+      camera_x = game->camera.x();
+      camera_y = game->camera.y();
+    }
+
+    target_x = metrics.clamp_camera_x(x);
+    target_y = metrics.clamp_camera_y(y);
+  }
+
+  void follow::cancel()
+  {
+    game = nullptr;
+  }
+
+  void follow::update()
+  {
+    if (game == nullptr)
+    {
+      return;
+    }
+
+    // Targets and the camera are clamped, so is anything in between
+    bn::fixed goal_x = camera_x;
+    bn::fixed goal_y = camera_y;
+
+    if (target_x > camera_x + deadzone_x)
+    {
+      goal_x = target_x - deadzone_x;
+    }
+    else if (target_x < camera_x - deadzone_x)
+    {
+      goal_x = target_x + deadzone_x;
+    }
+
+    if (target_y > camera_y + deadzone_y)
+    {
+      goal_y = target_y - deadzone_y;
+    }
+    else if (target_y < camera_y - deadzone_y)
+    {
+      goal_y = target_y + deadzone_y;
+    }
+
+    camera_x += (goal_x - camera_x) * lerp;
+    camera_y += (goal_y - camera_y) * lerp;
+
+    game->camera.set_position(camera_x.round_integer(), camera_y.round_integer());
   }
 }
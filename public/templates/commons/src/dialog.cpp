@@ -2,31 +2,32 @@
 
 #include <bn_core.h>
 #include <bn_log.h>
-#include <bn_sstream.h>
 #include <bn_display.h>
-#include <bn_sprite_item.h>
-#include <bn_sprite_text_generator.h>
 
 #include <bn_regular_bg_items_textbox_2l.h>
 #include <bn_regular_bg_items_textbox_3l.h>
-#include <bn_sprite_items_gbs_mono.h>
 
 #include <neo_types.h>
 
 #include "dialog.h"
 #include "game.h"
-#include "buttons.h"
-#include "utils.h"
+#include "input.h"
 
 namespace neo
 {
-  dialog::dialog (neo::game* game_, const bn::vector<bn::string_view, MAX_LINES>& lines_):
+  dialog::dialog (neo::game* game_, const neo::types::dialog_event& event):
     game(game_),
-    lines_count(lines_.size()),
-    lines(lines_),
+    pages(event.pages),
+    pages_count(event.pages_count),
+    lines_count(bn::min(event.lines_count, MAX_LINES)),
+    speed(bn::max(event.speed, 1)),
     direction(neo::types::direction::DOWN),
     bg_2_lines(bn::regular_bg_items::textbox_2l),
-    bg_3_lines(bn::regular_bg_items::textbox_3l)
+    bg_3_lines(bn::regular_bg_items::textbox_3l),
+    current_page(0),
+    page({ 0, 1, nullptr }),
+    next_page(pages),
+    reveal(0)
   {}
 
   bn::regular_bg_item dialog::get_background ()
@@ -38,67 +39,104 @@ namespace neo
 
   void dialog::show ()
   {
-    BN_LOG("Lines count: ", lines_count);
-    bn::regular_bg_ptr bg = get_background().create_bg(0, 0);
+    BN_LOG("Pages count: ", pages_count, ", lines count: ", lines_count);
+    bg = get_background().create_bg(0, 0);
 
     // Show the textbox background
-    bg.set_visible(true);
-    bg.set_priority(0);
-    bg.set_top_left_position(
-      (neo::types::SCREEN_WIDTH - bg.dimensions().width()) / 2,
+    bg->set_visible(true);
+    bg->set_priority(0);
+    bg->set_top_left_position(
+      (neo::types::SCREEN_WIDTH - bg->dimensions().width()) / 2,
       bn::display::height() - neo::dialog::PADDING * 2 - neo::dialog::LINE_HEIGHT * (lines_count + 1)
     );
 
-    bn::vector<bn::sprite_ptr, neo::dialog::MAX_LINES * neo::dialog::MAX_LENGTH> text_sprites;
+    // Text goes on its own BG layer, over the textbox
+    game->text.show(
+      (int)bg->top_left_position().x() + neo::dialog::PADDING * 2 + 2,
+      (int)bg->top_left_position().y() + neo::dialog::PADDING + 2,
+      0
+    );
 
-    // Create font
-    bn::sprite_font font = bn::sprite_font(bn::sprite_items::gbs_mono);
+    start_page(0);
+  }
 
-    // Create text generator and render the text
-    bn::sprite_text_generator text_generator(font);
-    text_generator.set_left_alignment();
-    text_generator.set_bg_priority(0);
+  void dialog::start_page (int index)
+  {
+    // Pages follow each other: lines count, width, glyphs count, then the
+    // glyphs two per word
+    const unsigned short* code = index == 0 ? pages : next_page;
+    const int glyphs_count = code[2];
+
+    page = { code[0], code[1], reinterpret_cast<const unsigned char*>(code + 3) };
+    next_page = code + 3 + (glyphs_count + 1) / 2;
+
+    // update() makes the characters appear a few at a time
+    game->text.clear();
+    current_page = index;
+    reveal = 0;
+  }
 
-    // Render each line
-    for (int i = 0; i < lines_count; ++i)
+  void dialog::reveal_glyphs (int count)
+  {
+    const int glyphs_count = bn::min(page.lines_count, MAX_LINES) * page.width;
+
+    // Blanks (spaces and line padding) are already there
+    for (int revealed = 0; reveal < glyphs_count && revealed < count; ++reveal)
     {
-      bn::string_view line = lines.at(i);
-
-      // Calculate text position
-      bn::fixed text_x = bg.top_left_position().x() + neo::dialog::PADDING * 2 - (bn::display::width() / 2) + 2;
-      bn::fixed text_y = bg.top_left_position().y() + neo::dialog::PADDING * 2 - (bn::display::height() / 2) - 2 + (i * neo::dialog::LINE_HEIGHT);
-
-      // Generate the text sprites for each line
-      text_generator.generate(
-        text_x,
-        text_y,
-        line,
-        text_sprites
-      );
+      if (int glyph = page.glyphs[reveal])
+      {
+        game->text.put(reveal % page.width, reveal / page.width, glyph);
+        ++revealed;
+      }
     }
+  }
 
-    // Hide the sprites first
-    for (bn::sprite_ptr& sprite : text_sprites)
+  bool dialog::update ()
+  {
+    if (!bg.has_value())
     {
-      sprite.set_visible(false);
+      return true;
     }
 
-    // Then make them appear one by one
-    for (bn::sprite_ptr& sprite : text_sprites)
+    const int glyphs_count = bn::min(page.lines_count, MAX_LINES) * page.width;
+
+    if (reveal < glyphs_count)
     {
-      sprite.set_visible(true);
+      if (neo::input::pressed(neo::input::A))
+      {
+        reveal_glyphs(glyphs_count);
+      }
+      else
+      {
+        reveal_glyphs(neo::input::held(neo::input::B) ? speed * FAST_FORWARD : speed);
+      }
+
+      return false;
+    }
 
-      neo::utils::wait(16); // 1 frame at 60 FPS
-      bn::core::update();
+    if (!neo::input::pressed(neo::input::A))
+    {
+      return false;
     }
 
-    while (!neo::buttons::is_pressed("A"))
+    if (current_page + 1 < pages_count)
     {
-      bn::core::update();
+      start_page(current_page + 1);
+      return false;
     }
 
-    // Hide dialog
-    text_sprites.clear();
-    bg.set_visible(false);
+    hide();
+    return true;
+  }
+
+  void dialog::hide ()
+  {
+    game->text.hide();
+
+    if (bg.has_value())
+    {
+      bg->set_visible(false);
+      bg.reset();
+    }
   }
 }
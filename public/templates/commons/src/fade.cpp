@@ -2,61 +2,94 @@
 #include <bn_blending_actions.h>
 #include <bn_regular_bg_ptr.h>
 
+#include "fade.h"
+
 namespace neo::fade
 {
-  void enter(bn::regular_bg_ptr& bg, int duration)
+  void transition::enter(bn::regular_bg_ptr& bg_, int duration)
   {
+    bg = &bg_;
+    is_entering = true;
+    action.reset();
+
     if (duration <= 0)
     {
       bn::blending::set_fade_alpha(0);
-      bg.set_blending_enabled(false);
-      bg.set_visible(true);
+      bg->set_blending_enabled(false);
+      bg->set_visible(true);
 
       return;
     }
 
     bn::blending::set_fade_alpha(1);
     bn::blending::set_black_fade_color();
-    bg.set_blending_enabled(true);
-    bg.set_visible(true);
+    bg->set_blending_enabled(true);
+    bg->set_visible(true);
     int frames = duration / 16; // Assuming 60 FPS, 16ms per frame
-    bn::blending_fade_alpha_to_action action(frames, 0);
-
-    while (!action.done())
-    {
-      action.update();
-      bn::core::update();
-    }
-
-    bn::blending::set_fade_alpha(0);
-    bg.set_blending_enabled(false);
+    action = bn::blending_fade_alpha_to_action(frames, 0);
   }
 
-  void exit(bn::regular_bg_ptr& bg, int duration)
+  void transition::exit(bn::regular_bg_ptr& bg_, int duration)
   {
+    bg = &bg_;
+    is_entering = false;
+    action.reset();
+
     if (duration <= 0)
     {
       bn::blending::set_fade_alpha(1);
-      bg.set_blending_enabled(false);
-      bg.set_visible(false);
+      bg->set_blending_enabled(false);
+      bg->set_visible(false);
 
       return;
     }
 
     bn::blending::set_fade_alpha(0);
     bn::blending::set_black_fade_color();
-    bg.set_blending_enabled(true);
+    bg->set_blending_enabled(true);
     int frames = duration / 16; // Assuming 60 FPS, 16ms per frame
-    bn::blending_fade_alpha_to_action action(frames, 1);
+    action = bn::blending_fade_alpha_to_action(frames, 1);
+  }
 
-    while (!action.done())
+  void transition::cancel()
+  {
+    action.reset();
+    bg = nullptr;
+  }
+
+  bool transition::update()
+  {
+    if (!action.has_value())
     {
-      action.update();
-      bn::core::update();
+      return false;
     }
 
-    bn::blending::set_fade_alpha(1);
-    bg.set_blending_enabled(false);
-    bg.set_visible(false);
+    if (!action->done())
+    {
+      action->update();
+      return false;
+    }
+
+    finish();
+    return true;
+  }
+
+  void transition::finish()
+  {
+    action.reset();
+
+    if (is_entering)
+    {
+      bn::blending::set_fade_alpha(0);
+      bg->set_blending_enabled(false);
+    }
+    else
+    {
+      bn::blending::set_fade_alpha(1);
+      bg->set_blending_enabled(false);
+      bg->set_visible(false);
+    }
+
+    bg = nullptr;
   }
 }
@@ -4,10 +4,11 @@
 #include <bn_vector.h>
 #include <bn_camera_actions.h>
 #include <bn_log.h>
-#include <bn_keypad.h>
 #include <bn_audio.h>
 #include <bn_music.h>
 #include <bn_sound.h>
+#include <bn_math.h>
+#include <bn_utility.h>
 
 #include "bn_music_items_info.h"
 #include "bn_sound_items_info.h"
@@ -19,13 +20,15 @@
 #include "player.h"
 #include "game.h"
 #include "commons.h"
-#include "utils.h"
 #include "fade.h"
 #include "buttons.h"
+#include "watchers.h"
 #include "actor.h"
 #include "sprite.h"
 #include "dialog.h"
 #include "camera.h"
+#include "bench.h"
+#include "input.h"
 
 namespace neo
 {
@@ -37,61 +40,57 @@ namespace neo
     player(player_),
     variables(),
     active_scene(nullptr),
-    scene_bg(nullptr)
+    scene_bg(nullptr),
+    last_goto_event(),
+    active_dialog(nullptr),
+    music_fade_volume(-1)
   {
     current_scene = neo::scenes::STARTING_SCENE;
     scene_changed = false;
 
-    scripted_events_count = 0;
     actors_count = 0;
     sprites_count = 0;
   }
 
-  void game::set_scene(bn::string_view scene_name)
+  void game::set_scene(int scene_id)
   {
-    current_scene = scene_name;
+    current_scene = scene_id;
     scene_changed = true;
   }
 
+  void game::set_scene(bn::string_view scene_name)
+  {
+    set_scene(neo::scenes::find_scene(scene_name));
+  }
+
   void game::run () {
-    auto scene = neo::scenes::get_scene(current_scene);
-    active_scene = &scene;
+    const int scene_id = current_scene;
+    // Unknown ids fall back to the default scene, never null
+    active_scene = neo::scenes::get_scene(scene_id);
 
     BN_LOG("Loading scene: ", active_scene->name);
 
-    if (active_scene == nullptr)
-    {
-      bn::core::update();
-
-      return;
-    }
-
+    // Tasks and effects of the previous scene can't outlive it
+    BN_LOG("Cleaning up old tasks, count:", tasks.size(), ", jobs:", jobs.size());
+    tasks.clear();
+    jobs.clear();
+    stop_effects();
 
     // Clean up old actors just in case
-    BN_LOG("Cleaning up old actors, count:", actors_count);
-    if (actors_count > 0)
-    {
-      for (int i = 0; i < actors_count; ++i)
-      {
-        delete actors[i];
-      }
-
-      actors.clear();
-      actors_count = 0;
-    }
+    BN_LOG("Cleaning up old actors, count:", actors_count, ", high water:", actors_pool.high_water(), "/", actors_pool.max_size());
+    actors_pool.clear();
+    actors.clear();
+    actors_count = 0;
+    occupancy.clear();
 
     // Clean up old sprites just in case
-    BN_LOG("Cleaning up old sprites, count:", sprites_count);
-    if (sprites_count > 0)
-    {
-      for (int i = 0; i < sprites_count; ++i)
-      {
-        delete sprites[i];
-      }
+    BN_LOG("Cleaning up old sprites, count:", sprites_count, ", high water:", sprites_pool.high_water(), "/", sprites_pool.max_size());
+    sprites_pool.clear();
+    sprites.clear();
+    sprites_count = 0;
 
-      sprites.clear();
-      sprites_count = 0;
-    }
+    // Only keep the tiles of the sprites used by the new scene
+    sprite_tiles.clear();
 
     bn::regular_bg_ptr bg = active_scene->background.create_bg(0, 0);
     scene_bg = &bg;
@@ -100,6 +99,8 @@ namespace neo
     scene_bg->set_priority(3);
     scene_changed = false;
 
+    load_map_metrics();
+
     BN_LOG("Starting scene: ", active_scene->name);
 
     if (active_scene->has_player && active_scene->map_data != nullptr)
@@ -112,17 +113,17 @@ namespace neo
       neo::types::direction dir = active_scene->start_direction;
 
       if (
-        last_goto_event != nullptr &&
-        active_scene->is(last_goto_event->target) &&
-        last_goto_event->start_x->as_int(variables) != -1 &&
-        last_goto_event->start_y->as_int(variables) != -1
+        last_goto_event.has_value() &&
+        last_goto_event->target_id == current_scene &&
+        last_goto_event->start_x != -1 &&
+        last_goto_event->start_y != -1
       )
       {
         BN_LOG("Using last go-to-scene event position");
-        x = last_goto_event->start_x->as_int(variables);
-        y = last_goto_event->start_y->as_int(variables);
+        x = last_goto_event->start_x;
+        y = last_goto_event->start_y;
         dir = last_goto_event->start_direction;
-        last_goto_event = nullptr;
+        last_goto_event.reset();
       }
 
       BN_LOG("Player start position: x=", x, ", y=", y, ", z=", z);
@@ -138,463 +139,884 @@ namespace neo
       );
     }
 
-    // Actors
-    BN_LOG("Actors count: ", active_scene->actors_count);
-    if (actors_count > 0)
-    {
-      actors.clear();
-    }
+    // Scripts
+    BN_LOG("Previous button handlers count: ", button_handlers.size());
+    button_handlers.clear();
+    BN_LOG("Previous variable handlers count: ", variable_handlers.size());
+    variable_handlers.clear();
 
-    actors_count = active_scene->actors_count;
+    // Actors and sprites are spawned by jobs, spread over as many frames
+    // as it takes to stay in the frame budget
+    BN_LOG("Actors count: ", active_scene->actors_count);
+    int scene_actors_count = active_scene->actors != nullptr ? active_scene->actors_count : 0;
 
-    if (active_scene->actors != nullptr)
+    if (scene_actors_count > MAX_ACTORS)
     {
-      for (int i = 0; i < actors_count; ++i)
-      {
-        BN_LOG("Creating actor: ", active_scene->actors[i]->name);
-        neo::actor* a = new neo::actor(this, active_scene->actors[i]);
-        actors.push_back(a);
-
-        // Execute actors init events
-        a->init();
-      }
+      BN_LOG("Too many actors, ignoring the last: ", scene_actors_count - MAX_ACTORS);
+      scene_actors_count = MAX_ACTORS;
     }
 
-    // Sprites
-    BN_LOG("Sprites count: ", active_scene->sprites_count);
-    if (sprites_count > 0)
+    for (int i = 0; i < scene_actors_count; ++i)
     {
-      sprites.clear();
+      jobs.push({ [](void* context, int index) {
+        static_cast<neo::game*>(context)->spawn_actor(index);
+      }, this, i, true });
     }
 
-    sprites_count = active_scene->sprites_count;
+    BN_LOG("Sprites count: ", active_scene->sprites_count);
+    int scene_sprites_count = active_scene->sprites != nullptr ? active_scene->sprites_count : 0;
 
-    if (active_scene->sprites != nullptr)
+    if (scene_sprites_count > MAX_SPRITES)
     {
-      for (int i = 0; i < sprites_count; ++i)
-      {
-        BN_LOG("Creating sprite: ", active_scene->sprites[i]->name);
-        neo::sprite* s = new neo::sprite(this, active_scene->sprites[i]);
-        sprites.push_back(s);
-      }
+      BN_LOG("Too many sprites, ignoring the last: ", scene_sprites_count - MAX_SPRITES);
+      scene_sprites_count = MAX_SPRITES;
     }
 
-    // Scripts
-    BN_LOG("Previous scripted events count: ", scripted_events_count);
-    if (scripted_events_count > 0)
+    for (int i = 0; i < scene_sprites_count; ++i)
     {
-      scripted_events.clear();
+      jobs.push({ [](void* context, int index) {
+        static_cast<neo::game*>(context)->spawn_sprite(index);
+      }, this, i, true });
     }
 
-    scripted_events_count = 0;
+    BN_LOG("Scene events size:", active_scene->events.size);
 
-    BN_LOG("Scene events count:", active_scene->event_count);
+    // Normal scene events run as a task, after the actors init events
+    jobs.push({ [](void* context, int) {
+      neo::game* game = static_cast<neo::game*>(context);
+      game->start_task(game->active_scene->events, false);
+    }, this, 0, true });
 
-    // Exec normal scene events
-    for (int i = 0; i < active_scene->event_count; ++i)
-    {
-      BN_LOG("Getting scene event ", i);
-      neo::types::event* e = active_scene->events[i];
-      BN_LOG("Executing scene event: ", e->type);
-      exec_event(e, false);
-    }
+    // As much of the setup as fits in the loading frame
+    jobs.drain();
 
     while (!scene_changed)
     {
-      // Exec in-loop scripted events
-      for (int i = 0; i < scripted_events_count; ++i)
+      // Button handlers and the player wait for blocking tasks (scene
+      // events, interactions, sensors) like they did when events blocked
+      if (!has_blocking_tasks() && !player.is_moving())
       {
-        neo::types::event* e = scripted_events[i];
-        BN_LOG("Executing in-loop scripted event: ", e->type);
-        exec_event(e, true);
+        button_handlers.dispatch([this](const neo::types::button_event& handler) {
+          BN_LOG("Button pressed, executing events");
+          start_task(handler.events, true);
+        });
       }
 
-      if (active_scene->has_player)
+      if (active_scene->has_player && !has_blocking_tasks())
       {
         player.update();
       }
 
-      for (int i = 0; i < actors_count; ++i)
+      update_effects();
+      update_tasks();
+
+      // Deferred work fills what is left of the frame
+      if (!scene_changed)
       {
-        // Execute actors update events
-        actors[i]->update();
+        jobs.drain();
       }
 
       bn::core::update();
+      neo::input::update();
+      neo::bench::sample(scene_id, active_scene->name);
     }
 
+    stop_effects();
     bg.set_visible(false);
+    scene_bg = nullptr;
   }
 
-  void game::exec_event (const neo::types::event* e, bool is_loop) {
-    /**
-     * @name wait
-     * @param duration number (default: 500)
-     */
-    if (e->type == "wait")
+  void game::spawn_actor (int index)
+  {
+    BN_LOG("Creating actor: ", active_scene->actors[index]->name);
+    neo::actor* a = actors_pool.create(this, active_scene->actors[index]);
+
+    if (a == nullptr)
     {
-      const neo::types::wait_event* wait_evt =
-        static_cast<const neo::types::wait_event*>(e);
-      neo::utils::wait(wait_evt->duration->as_int(variables));
+      return;
     }
 
-    /**
-     * @name fade-in
-     * @param duration number (default: 500)
-     */
-    else if (e->type == "fade-in" && scene_bg != nullptr)
+    actors.push_back(a);
+    actors_count = actors.size();
+
+    // Execute actors init events
+    a->init();
+  }
+
+  void game::spawn_sprite (int index)
+  {
+    BN_LOG("Creating sprite: ", active_scene->sprites[index]->name);
+    neo::sprite* s = sprites_pool.create(this, active_scene->sprites[index]);
+
+    if (s == nullptr)
     {
-      const neo::types::fade_event* fade_evt =
-        static_cast<const neo::types::fade_event*>(e);
+      return;
+    }
 
-      int duration = fade_evt->duration->as_int(variables);
-      BN_LOG("Fade-in duration: ", duration);
+    sprites.push_back(s);
+    sprites_count = sprites.size();
+  }
 
-      enable_blending();
-      neo::fade::enter(*scene_bg, duration);
-      disable_blending();
+  void game::start_task (const neo::types::event_list& events, bool in_loop, bool repeat)
+  {
+    if (events.empty())
+    {
+      return;
     }
 
-    /**
-     * @name fade-out
-     * @param duration number (default: 500)
-     */
-    else if (e->type == "fade-out" && scene_bg != nullptr)
+    if (tasks.full())
     {
-      const neo::types::fade_event* fade_evt =
-        static_cast<const neo::types::fade_event*>(e);
+      BN_LOG("Too many tasks, ignoring events");
+      return;
+    }
+
+    tasks.push_back(neo::task(events, in_loop, repeat));
+  }
+
+  void game::update_tasks ()
+  {
+    for (int i = 0; i < tasks.size() && !scene_changed; ++i)
+    {
+      step_task(tasks[i]);
+    }
+
+    // Drop finished tasks, keeping the execution order of the others
+    int alive = 0;
+
+    for (int i = 0; i < tasks.size(); ++i)
+    {
+      if (!tasks[i].finished())
+      {
+        if (alive != i)
+        {
+          tasks[alive] = tasks[i];
+        }
 
-      enable_blending();
-      neo::fade::exit(*scene_bg, fade_evt->duration->as_int(variables));
+        ++alive;
+      }
     }
 
-    /**
-     * @name wait-for-button
-     * @param buttons array of button names (event is ignored if empty)
-     */
-    else if (e->type == "wait-for-button")
+    tasks.shrink(alive);
+  }
+
+  void game::step_task (neo::task& task)
+  {
+    if (is_waiting(task))
     {
-      const neo::types::button_event* button_evt =
-        static_cast<const neo::types::button_event*>(e);
-      while (!neo::buttons::any_pressed(button_evt->buttons))
+      return;
+    }
+
+    while (!task.finished() && !scene_changed)
+    {
+      neo::code::reader& frame = task.frames.back();
+
+      if (frame.finished())
       {
-        bn::core::update();
+        task.frames.pop_back();
+        continue;
+      }
+
+      if (exec_event(frame, task))
+      {
+        return;
       }
     }
 
-    /**
-     * @name go-to-scene
-     * @param target string — Scene name, without scene_ prefix (default: "default")
-     * @param start.object object with:
-     *   x number (default: 0)
-     *   y number (default: 0)
-     *   direction string (default: "down")
-     */
-    else if (e->type == "go-to-scene")
+    // Repeating tasks run again on the next frame
+    if (task.repeat && task.finished())
     {
-      const neo::types::scene_event* scene_evt =
-        static_cast<const neo::types::scene_event*>(e);
-      scene_changed = true;
-      current_scene = scene_evt->target;
-      last_goto_event = const_cast<neo::types::scene_event*>(scene_evt);
+      task.restart();
     }
+  }
 
-    /**
-     * @name on-button-press
-     * @param buttons array of button names (event is ignored if empty)
-     */
-    else if (e->type == "on-button-press")
+  bool game::is_waiting (neo::task& task)
+  {
+    switch (task.wait)
     {
-      const neo::types::button_event* button_evt =
-        static_cast<const neo::types::button_event*>(e);
+      case neo::task_wait::FRAMES:
+        if (--task.wait_frames > 0) return true;
+        break;
+      case neo::task_wait::BUTTON:
+        if (!neo::buttons::fired(task.wait_buttons)) return true;
+        break;
+      case neo::task_wait::FADE:
+        if (fade.active()) return true;
+        break;
+      case neo::task_wait::DIALOG:
+        if (active_dialog != nullptr) return true;
+        break;
+      case neo::task_wait::CAMERA:
+        if (camera_tween.active()) return true;
+        break;
+      case neo::task_wait::MUSIC:
+        if (music_fade_volume >= 0) return true;
+        break;
+      default:
+        break;
+    }
 
-      if (is_loop) {
-        if (neo::buttons::any_pressed(button_evt->buttons))
-        {
-          BN_LOG("Button pressed, executing events");
-          for (int i = 0; i < button_evt->events_count; ++i)
-          {
-            neo::types::event* ev = button_evt->events[i];
-            exec_event(ev, true);
-          }
-        }
-      } else {
-        scripted_events_count++;
-        scripted_events.push_back(const_cast<neo::types::event*>(e));
+    task.wait = neo::task_wait::NONE;
+    return false;
+  }
+
+  bool game::has_blocking_tasks ()
+  {
+    // A scene still being set up can't be played yet
+    if (jobs.has_blocking())
+    {
+      return true;
+    }
+
+    for (const neo::task& task : tasks)
+    {
+      if (!task.repeat)
+      {
+        return true;
       }
     }
 
-    /**
-     * @name show-dialog
-     * @param text string — Dialog text
-     */
-    else if (e->type == "show-dialog")
+    return false;
+  }
+
+  void game::update_effects ()
+  {
+    if (fade.update() && fade.entering())
     {
-      const neo::types::dialog_event* dialog_evt =
-        static_cast<const neo::types::dialog_event*>(e);
-      neo::dialog* d = new neo::dialog(this, dialog_evt->lines);
-      d->show();
-      delete d;
+      disable_blending();
     }
 
-    /**
-     * @name set-variable
-     * @param name string — Variable name
-     * @param value string — Variable value
-     */
-    else if (e->type == "set-variable")
+    if (active_dialog != nullptr && active_dialog->update())
     {
-      const neo::types::set_variable_event* set_var_evt =
-        static_cast<const neo::types::set_variable_event*>(e);
-      variables.set(set_var_evt->key, set_var_evt->value);
+      dialogs_pool.destroy(active_dialog);
+      active_dialog = nullptr;
     }
 
-    else if (e->type == "if")
+    camera_tween.update();
+    camera_follow.update();
+
+    if (music_fade_volume >= 0)
     {
-      const neo::types::if_event* if_evt =
-        static_cast<const neo::types::if_event*>(e);
+      bn::music::set_volume(music_fade_volume / 100.0);
+      --music_fade_volume;
 
-      bool result = true;
-      for (int i = 0; i < if_evt->conditions_count; ++i)
+      if (music_fade_volume < 0)
       {
-        if (!evaluate_condition(if_evt->conditions[i]))
+        bn::music::stop();
+      }
+    }
+  }
+
+  void game::stop_effects ()
+  {
+    fade.cancel();
+    camera_tween.cancel();
+    camera_follow.cancel();
+
+    if (active_dialog != nullptr)
+    {
+      active_dialog->hide();
+      dialogs_pool.destroy(active_dialog);
+      active_dialog = nullptr;
+    }
+  }
+
+  bool game::exec_event (neo::code::reader& code, neo::task& task) {
+    const unsigned opcode = code.word();
+
+    // Operands are read even when the event ends up doing nothing, the
+    // next event starts right after them
+    switch ((neo::types::event_type)opcode)
+    {
+      /**
+       * @name wait
+       * @param duration number (default: 500)
+       */
+      case neo::types::event_type::WAIT:
+      {
+        int frames = code.value(variables) / 16; // Assuming 60 FPS, 16ms per frame
+
+        if (frames > 0)
+        {
+          task.wait = neo::task_wait::FRAMES;
+          task.wait_frames = frames;
+          return true;
+        }
+        break;
+      }
+
+      /**
+       * @name fade-in
+       * @param duration number (default: 500)
+       */
+      case neo::types::event_type::FADE_IN:
+      {
+        int duration = code.value(variables);
+
+        if (scene_bg == nullptr)
         {
-          result = false;
           break;
         }
+
+        BN_LOG("Fade-in duration: ", duration);
+
+        enable_blending();
+        fade.enter(*scene_bg, duration);
+
+        if (fade.active())
+        {
+          task.wait = neo::task_wait::FADE;
+          return true;
+        }
+
+        disable_blending();
+        break;
       }
 
-      if (result)
+      /**
+       * @name fade-out
+       * @param duration number (default: 500)
+       */
+      case neo::types::event_type::FADE_OUT:
       {
-        for (int i = 0; i < if_evt->then_events_count; ++i)
+        int duration = code.value(variables);
+
+        if (scene_bg == nullptr)
         {
-          neo::types::event* ev = if_evt->then_events[i];
-          exec_event(ev, is_loop);
+          break;
         }
-      } else {
-        for (int i = 0; i < if_evt->else_events_count; ++i)
+
+        enable_blending();
+        fade.exit(*scene_bg, duration);
+
+        if (fade.active())
         {
-          neo::types::event* ev = if_evt->else_events[i];
-          exec_event(ev, is_loop);
+          task.wait = neo::task_wait::FADE;
+          return true;
         }
+        break;
       }
-    }
 
-    /**
-     * @name disable-actor
-     * @param actor string — Actor name
-     */
-    else if (e->type == "disable-actor")
-    {
-      const neo::types::disable_actor_event* disable_actor_evt =
-        static_cast<const neo::types::disable_actor_event*>(e);
+      /**
+       * @name wait-for-button
+       * @param buttons array of button names (event is ignored if empty)
+       * @param trigger string — "pressed", "held" or "released" (default: "pressed")
+       * @param every boolean — wait for all the buttons (default: false)
+       */
+      case neo::types::event_type::WAIT_FOR_BUTTON:
+      {
+        task.wait = neo::task_wait::BUTTON;
+        task.wait_buttons = code.buttons();
+        return true;
+      }
 
-      for (int i = 0; i < actors_count; ++i)
+      /**
+       * @name go-to-scene
+       * @param target string — Scene name, without scene_ prefix (default: "default")
+       * @param start.object object with:
+       *   x number (default: 0)
+       *   y number (default: 0)
+       *   direction string (default: "down")
+       */
+      case neo::types::event_type::GO_TO_SCENE:
       {
-        if (
-          actors[i]->definition->name == disable_actor_evt->actor ||
-          actors[i]->definition->_id == disable_actor_evt->actor
-        ) {
-          BN_LOG("Disabling actor: ", actors[i]->definition->name);
-          actors[i]->disable();
-          break;
+        neo::types::scene_event scene_evt;
+        scene_evt.target_id = code.word();
+        scene_evt.start_x = code.value(variables);
+        scene_evt.start_y = code.value(variables);
+        scene_evt.start_direction = (neo::types::direction)code.word();
+
+        scene_changed = true;
+        current_scene = scene_evt.target_id;
+        last_goto_event = scene_evt;
+        return true;
+      }
+
+      /**
+       * @name on-button-press
+       * @param buttons array of button names (event is ignored if empty)
+       * @param trigger string — "pressed", "held" or "released" (default: "pressed")
+       * @param every boolean — fire on all the buttons (default: false)
+       */
+      case neo::types::event_type::ON_BUTTON_PRESS:
+      {
+        neo::types::button_event button_evt = code.buttons();
+        button_evt.events = code.body();
+
+        if (task.in_loop) {
+          if (neo::buttons::fired(button_evt))
+          {
+            BN_LOG("Button pressed, executing events");
+
+            // The handler code is right before, run it in place
+            code.jump(-button_evt.events.size);
+          }
+        } else {
+          button_handlers.add(button_evt);
         }
+        break;
       }
-    }
 
-    /**
-     * @name enable-actor
-     * @param actor string — Actor name
-     */
-    else if (e->type == "enable-actor")
-    {
-      const neo::types::enable_actor_event* enable_actor_evt =
-        static_cast<const neo::types::enable_actor_event*>(e);
+      /**
+       * @name on-variable-change
+       * @param name string — Variable name
+       * @param operator string — Filter on the new value: ==, !=, <, <=, > or >= (default: any change)
+       * @param value string — Compared with the new value
+       * @param events array of events
+       */
+      case neo::types::event_type::ON_VARIABLE_CHANGE:
+      {
+        neo::types::variable_event variable_evt = code.watch();
+        variable_evt.events = code.body();
+        variable_handlers.add(variable_evt);
+        break;
+      }
+
+      /**
+       * @name show-dialog
+       * @param text string — Dialog text, word wrapped and split in pages at build time
+       * @param speed number — Characters revealed per frame (default: 4)
+       */
+      case neo::types::event_type::SHOW_DIALOG:
+      {
+        neo::types::dialog_event dialog_evt;
+        dialog_evt.lines_count = code.word();
+        dialog_evt.speed = code.word();
+        dialog_evt.pages_count = code.word();
+        dialog_evt.pages = code.position();
+
+        for (int i = 0; i < dialog_evt.pages_count; ++i)
+        {
+          int glyphs_count;
+          code.word(); // Lines count
+          code.word(); // Width
+          code.bytes(glyphs_count);
+        }
+
+        if (active_dialog != nullptr)
+        {
+          active_dialog->hide();
+          dialogs_pool.destroy(active_dialog);
+        }
+
+        active_dialog = dialogs_pool.create(this, dialog_evt);
+        active_dialog->show();
+
+        task.wait = neo::task_wait::DIALOG;
+        return true;
+      }
 
-      for (int i = 0; i < actors_count; ++i)
+      /**
+       * @name set-variable
+       * @param name string — Variable name
+       * @param value string — Variable value
+       */
+      /**
+       * @name update-variable
+       * @param name string — Variable name
+       * @param operation string — inc, dec, add, sub, mul, clamp or random
+       * @param value string — Operand of add, sub and mul
+       * @param min string — Lower bound of clamp and random
+       * @param max string — Upper bound of clamp and random
+       */
+      case neo::types::event_type::SET_VARIABLE:
+      case neo::types::event_type::ADD_VARIABLE:
+      case neo::types::event_type::SUBTRACT_VARIABLE:
+      case neo::types::event_type::MULTIPLY_VARIABLE:
+      case neo::types::event_type::CLAMP_VARIABLE:
+      case neo::types::event_type::RANDOM_VARIABLE:
       {
+        int slot = update_variable((neo::types::event_type)opcode, code);
+
         if (
-          actors[i]->definition->name == enable_actor_evt->actor ||
-          actors[i]->definition->_id == enable_actor_evt->actor
+          active_scene != nullptr &&
+          active_scene->map_data != nullptr &&
+          active_scene->map_data->grid_size->slot == slot
         )
         {
-          BN_LOG("Enabling actor: ", actors[i]->definition->name);
-          actors[i]->enable();
-          break;
+          load_map_metrics();
         }
+        break;
       }
-    }
-
-    /**
-     * @name play-music
-     * @param name string — Music name from assets/audio
-     * @param volume bn::fixed (default: 1.0) / range: [0..1]
-     * @param loop boolean — Whether to loop the music (default: false)
-     */
-    else if (e->type == "play-music")
-    {
-      const neo::types::play_music_event* music_evt =
-        static_cast<const neo::types::play_music_event*>(e);
 
-      for (const auto& [item, name] : bn::music_items_info::span)
+      /**
+       * @name if
+       * @param conditions array — All of them must hold for the then branch,
+       * each one a comparison or the && or || of two conditions
+       * @param then array of events
+       * @param else array of events
+       */
+      case neo::types::event_type::IF:
       {
-        if (name == music_evt->music_name && !bn::music::playing())
-        {
-          BN_LOG("Playing music: ", name);
-          item.play(music_evt->volume / 100, music_evt->loop);
+        bool result = evaluate_condition(code);
 
-          break;
+        // Then branch follows, the else one is past this jump
+        int else_offset = code.word();
+
+        if (!result)
+        {
+          code.jump(else_offset);
         }
+        break;
       }
-    }
 
-    /**
-     * @name stop-music
-     */
-    else if (e->type == "stop-music")
-    {
-      BN_LOG("Stopping music");
-      const auto& current_music = bn::music::playing_item();
+      // End of a then branch, over the else one
+      case neo::types::event_type::JUMP:
+      {
+        int offset = code.word();
+        code.jump(offset);
+        break;
+      }
 
-      if (current_music.has_value())
+      /**
+       * @name disable-actor
+       * @param actor string — Actor name
+       */
+      case neo::types::event_type::DISABLE_ACTOR:
       {
-        for (int i = (int)(bn::music::volume() * 100); i >= 0; i -= 1)
+        bn::string_view actor = code.string();
+
+        for (int i = 0; i < actors_count; ++i)
         {
-          BN_LOG("Fading out music to: ", i);
-          bn::music::set_volume(i / 100.0);
-          neo::utils::wait(10);
-          bn::core::update();
+          if (
+            actors[i]->definition->name == actor ||
+            actors[i]->definition->_id == actor
+          ) {
+            BN_LOG("Disabling actor: ", actors[i]->definition->name);
+            actors[i]->disable();
+            break;
+          }
         }
-
-        bn::music::stop();
+        break;
       }
-    }
 
-    /**
-     * @name play-sound
-     * @param sound_name string — Sound name from sounds.xml
-     * @param volume bn::fixed (default: 1.0) / range: [0..1]
-     * @param speed bn::fixed (default: 1) /range: [0..64]
-     * @param panning bn::fixed (default: 0) / range: [-1..1]
-     * @param priority int (default: 32767) / range: [-32767..32767]
-     */
-    else if (e->type == "play-sound")
-    {
-      const neo::types::play_sound_event* sound_evt =
-        static_cast<const neo::types::play_sound_event*>(e);
+      /**
+       * @name enable-actor
+       * @param actor string — Actor name
+       */
+      case neo::types::event_type::ENABLE_ACTOR:
+      {
+        bn::string_view actor = code.string();
 
-      for (const auto& [item, name] : bn::sound_items_info::span)
+        for (int i = 0; i < actors_count; ++i)
+        {
+          if (
+            actors[i]->definition->name == actor ||
+            actors[i]->definition->_id == actor
+          )
+          {
+            BN_LOG("Enabling actor: ", actors[i]->definition->name);
+            actors[i]->enable();
+            break;
+          }
+        }
+        break;
+      }
+
+      /**
+       * @name play-music
+       * @param name string — Music name from assets/audio
+       * @param volume bn::fixed (default: 1.0) / range: [0..1]
+       * @param loop boolean — Whether to loop the music (default: false)
+       */
+      case neo::types::event_type::PLAY_MUSIC:
       {
-        if (name == sound_evt->sound_name)
+        bn::string_view music_name = code.string();
+        bn::fixed volume = code.fixed();
+        bool loop = code.word();
+
+        for (const auto& [item, name] : bn::music_items_info::span)
         {
-          BN_LOG("Playing sound: ", name);
+          if (name == music_name && !bn::music::playing())
+          {
+            BN_LOG("Playing music: ", name);
+            item.play(volume / 100, loop);
 
-          item.play_with_priority(
-            sound_evt->priority,
-            sound_evt->volume / 100,
-            sound_evt->speed,
-            sound_evt->panning / 100
-          );
+            break;
+          }
+        }
+        break;
+      }
 
-          break;
+      /**
+       * @name stop-music
+       */
+      case neo::types::event_type::STOP_MUSIC:
+      {
+        BN_LOG("Stopping music");
+        const auto& current_music = bn::music::playing_item();
+
+        if (current_music.has_value())
+        {
+          // Faded out by update_effects, one volume step per frame
+          music_fade_volume = (int)(bn::music::volume() * 100);
+          task.wait = neo::task_wait::MUSIC;
+          return true;
         }
+        break;
       }
-    }
 
-    /**
-     * @name execute-script
-     * @param name string — Script name
-     */
-    else if (e->type == "execute-script")
-    {
-      const neo::types::execute_script_event* script_evt =
-        static_cast<const neo::types::execute_script_event*>(e);
-      auto script = neo::scenes::get_script(script_evt->name);
+      /**
+       * @name play-sound
+       * @param sound_name string — Sound name from sounds.xml
+       * @param volume bn::fixed (default: 1.0) / range: [0..1]
+       * @param speed bn::fixed (default: 1) /range: [0..64]
+       * @param panning bn::fixed (default: 0) / range: [-1..1]
+       * @param priority int (default: 32767) / range: [-32767..32767]
+       */
+      case neo::types::event_type::PLAY_SOUND:
+      {
+        bn::string_view sound_name = code.string();
+        bn::fixed volume = code.fixed();
+        bn::fixed speed = code.fixed();
+        bn::fixed panning = code.fixed();
+        int priority = (short)code.word();
+
+        for (const auto& [item, name] : bn::sound_items_info::span)
+        {
+          if (name == sound_name)
+          {
+            BN_LOG("Playing sound: ", name);
+
+            item.play_with_priority(
+              priority,
+              volume / 100,
+              speed,
+              panning / 100
+            );
+
+            break;
+          }
+        }
+        break;
+      }
 
-      if (script.events_count > 0 && script.events != nullptr)
+      /**
+       * @name execute-script
+       * @param name string — Script name
+       */
+      case neo::types::event_type::EXECUTE_SCRIPT:
       {
-        BN_LOG("Executing script: ", script.name);
+        const neo::types::script* script = neo::scenes::get_script((short)code.word());
 
-        for (int i = 0; i < script.events_count; ++i)
+        if (!script->events.empty())
         {
-          neo::types::event* ev = script.events[i];
-          exec_event(ev, is_loop);
+          BN_LOG("Executing script: ", script->name);
+          task.push(script->events);
         }
+        break;
       }
-    }
 
-    else if (e->type == "move-camera-to")
-    {
-      const neo::types::move_camera_to_event* move_camera_evt =
-        static_cast<const neo::types::move_camera_to_event*>(e);
+      /**
+       * @name move-camera-to
+       * @param x number — Target tile column
+       * @param y number — Target tile row
+       * @param duration number — Milliseconds (default: 200)
+       * @param allowDiagonal boolean — Move both axes at once (default: true)
+       * @param directionPriority string — "horizontal" or "vertical" axis first
+       * @param easing string — "linear", "ease-in", "ease-out", "ease-in-out" or "smoothstep" (default: "linear")
+       */
+      case neo::types::event_type::MOVE_CAMERA_TO:
+      {
+        int x = code.value(variables);
+        int y = code.value(variables);
+        int duration = code.value(variables);
+        unsigned flags = code.word();
+        neo::types::easing easing = (neo::types::easing)code.word();
+
+        camera_tween.move_to(
+          this,
+          x,
+          y,
+          duration,
+          flags & 1,
+          (flags & 2) ? "vertical" : "horizontal",
+          easing
+        );
+
+        if (camera_tween.active())
+        {
+          task.wait = neo::task_wait::CAMERA;
+          return true;
+        }
+        break;
+      }
 
-      neo::camera::move_to(
-        this,
-        *active_scene,
-        move_camera_evt->x->as_int(variables),
-        move_camera_evt->y->as_int(variables),
-        move_camera_evt->duration->as_int(variables),
-        move_camera_evt->allow_diagonal,
-        move_camera_evt->direction_priority
-      );
-    }
+      /**
+       * Unknown events are ignored
+       */
+      case neo::types::event_type::UNKNOWN:
+      {
+        BN_LOG("Unknown event type");
+        break;
+      }
 
-    /**
-     * Unknown events are ignored
-     */
-    else
-    {
-      BN_LOG("Unknown event type: ", e->type);
+      // Not an opcode, its operands can't be skipped so the list ends here
+      default:
+      {
+        BN_LOG("Invalid event opcode: ", opcode);
+        code.jump(code.size - code.pc);
+        break;
+      }
     }
+
+    return false;
   }
 
-  bool game::evaluate_condition (neo::types::if_condition* condition)
+  /**
+   * Evaluates the condition tree at the reader and leaves it past the
+   * tree. AND and OR stop at the first child that decides them and jump
+   * over the others
+   */
+  bool game::evaluate_condition (neo::code::reader& code)
   {
-    if (condition->op == "==")
+    // The node, with the type both sides of a comparison are read as in
+    // the high byte
+    unsigned operation = code.word();
+    neo::code::comparison op = (neo::code::comparison)(operation & 0xFF);
+
+    if (op == neo::code::comparison::AND || op == neo::code::comparison::OR)
     {
-      bn::string_view left = get_expression_value(condition->left);
-      bn::string_view right = get_expression_value(condition->right);
+      bool decisive = op == neo::code::comparison::OR;
+      int size = code.word();
+      int end = code.pc + size;
 
-      BN_LOG("Evaluating condition: ", left, " == ", right);
+      while (code.pc < end)
+      {
+        if (evaluate_condition(code) == decisive)
+        {
+          code.jump(end - code.pc);
+          return decisive;
+        }
+      }
 
-      return left == right;
+      return !decisive;
     }
-    else if (condition->op == "!=")
+
+    neo::variables::type type = (neo::variables::type)(operation >> 8);
+    int left = code.value(variables, type);
+    int right = code.value(variables, type);
+
+    switch (op)
     {
-      return get_expression_value(condition->left) != get_expression_value(condition->right);
+      case neo::code::comparison::EQUAL:
+        return left == right;
+      case neo::code::comparison::NOT_EQUAL:
+        return left != right;
+      case neo::code::comparison::LESS:
+        return left < right;
+      case neo::code::comparison::LESS_EQUAL:
+        return left <= right;
+      case neo::code::comparison::GREATER:
+        return left > right;
+      case neo::code::comparison::GREATER_EQUAL:
+        return left >= right;
+      default:
+        return false;
     }
-
-    return false;
   }
 
-  bn::string_view game::get_expression_value (neo::types::if_expression* expression)
+  /**
+   * Operands are read as the type of the variable, so ints, bools and
+   * fixed point raw data all share the same int arithmetic except for
+   * fixed point products
+   */
+  int game::update_variable (neo::types::event_type type, neo::code::reader& code)
   {
-    if (expression->type == "variable")
+    int slot = code.word();
+    bool found = slot < neo::variables::COUNT;
+
+    // Operands are still read for an unknown slot, to get past them
+    neo::variables::type variable_type = found ? variables.type(slot) : neo::variables::type::INT;
+    int current = found ? variables.get(slot) : 0;
+    int result = current;
+
+    switch (type)
     {
-      auto* var_expr = static_cast<neo::types::if_expression_variable*>(expression);
+      case neo::types::event_type::SET_VARIABLE:
+        result = code.value(variables, variable_type);
+        break;
+
+      case neo::types::event_type::ADD_VARIABLE:
+        result = current + code.value(variables, variable_type);
+        break;
+
+      case neo::types::event_type::SUBTRACT_VARIABLE:
+        result = current - code.value(variables, variable_type);
+        break;
 
-      if (!variables.has(var_expr->name))
+      case neo::types::event_type::MULTIPLY_VARIABLE:
       {
-        BN_LOG("Variable not found: ", var_expr->name);
-        return "";
+        int operand = code.value(variables, variable_type);
+
+        if (variable_type == neo::variables::type::FIXED)
+        {
+          result = bn::fixed::from_data(current).safe_multiplication(bn::fixed::from_data(operand)).data();
+        }
+        else
+        {
+          result = current * operand;
+        }
+        break;
       }
 
-      // if comparison does not care about the type, always compares strings
-      // TODO: allow gt/lt/... comparisons
-      auto var_value = variables.get(var_expr->name);
+      case neo::types::event_type::CLAMP_VARIABLE:
+      {
+        int min = code.value(variables, variable_type);
+        int max = code.value(variables, variable_type);
+        result = bn::clamp(current, min, bn::max(min, max));
+        break;
+      }
+
+      case neo::types::event_type::RANDOM_VARIABLE:
+      {
+        int min = code.value(variables, variable_type);
+        int max = code.value(variables, variable_type);
+
+        if (max < min)
+        {
+          bn::swap(min, max);
+        }
+
+        result = random.get_int(min, max + 1);
+        break;
+      }
+
+      default:
+        break;
+    }
 
-      BN_LOG("[IF] Getting variable value: ", var_expr->name, "with value:", var_value.as_string());
+    if (!found)
+    {
+      BN_LOG("Variable not found: ", slot);
+      return -1;
+    }
 
-      return var_value.as_string();
+    if (variable_type == neo::variables::type::BOOL)
+    {
+      result = result != 0;
     }
-    else if (expression->type == "value")
+
+    if (variables.set(slot, result))
     {
-      auto* val_expr = static_cast<neo::types::if_expression_value*>(expression);
-      BN_LOG("[IF] Getting raw value: ", val_expr->value);
-      return val_expr->value;
+      variable_handlers.dispatch(slot, result, [this](const neo::types::variable_event& handler) {
+        BN_LOG("Variable changed, executing events");
+        start_task(handler.events, false);
+      });
     }
 
-    return "";
+    return slot;
+  }
+
+  void game::load_map_metrics ()
+  {
+    if (active_scene == nullptr || active_scene->map_data == nullptr)
+    {
+      map_metrics = neo::types::map_metrics();
+      return;
+    }
+
+    const neo::types::map* map = active_scene->map_data;
+    map_metrics.load(map->width, map->height, map->grid_size->as_int(variables));
   }
 
   void game::enable_blending ()
@@ -631,15 +1053,7 @@ namespace neo
 
   bool game::has_collision(int tile_x, int tile_y)
   {
-    for (int i = 0; i < actors_count; ++i)
-    {
-      if (actors[i]->collides(tile_x, tile_y))
-      {
-        return true;
-      }
-    }
-
-    return false;
+    return occupancy.at(tile_x, tile_y) != nullptr;
   }
 
   neo::actor* game::get_actor_at(int tile_x, int tile_y, neo::types::direction direction)
@@ -664,14 +1078,6 @@ namespace neo
       next_x += 1;
     }
 
-    for (int i = 0; i < actors_count; ++i)
-    {
-      if (actors[i]->collides(next_x, next_y))
-      {
-        return actors[i];
-      }
-    }
-
-    return nullptr;
+    return occupancy.at(next_x, next_y);
   }
 }
@@ -0,0 +1,130 @@
+#include <bn_core.h>
+#include <bn_keypad.h>
+#include <bn_log.h>
+
+#include "input.h"
+
+#ifdef NEO_INPUT_REPLAY
+  #include <neo_replay.h>
+#endif
+
+namespace neo::input
+{
+  namespace
+  {
+    int frame_count = 0;
+    unsigned held_mask = 0;
+    unsigned previous_mask = 0;
+
+#ifdef NEO_INPUT_REPLAY
+    int next_change = 0;
+
+    unsigned read_keys()
+    {
+      while (next_change < REPLAY_COUNT && REPLAY[next_change].frame <= frame_count)
+      {
+        held_mask = REPLAY[next_change++].keys;
+      }
+
+      return held_mask;
+    }
+#else
+    constexpr bn::keypad::key_type KEYS[] = {
+      bn::keypad::key_type::A,
+      bn::keypad::key_type::B,
+      bn::keypad::key_type::SELECT,
+      bn::keypad::key_type::START,
+      bn::keypad::key_type::RIGHT,
+      bn::keypad::key_type::LEFT,
+      bn::keypad::key_type::UP,
+      bn::keypad::key_type::DOWN,
+      bn::keypad::key_type::R,
+      bn::keypad::key_type::L
+    };
+
+    unsigned read_keys()
+    {
+      unsigned mask = 0;
+
+      for (int i = 0; i < 10; ++i)
+      {
+        if (bn::keypad::held(KEYS[i]))
+        {
+          mask |= 1u << i;
+        }
+      }
+
+      return mask;
+    }
+#endif
+
+#ifdef NEO_INPUT_RECORD
+    // Same format as the bench and host input scripts, so a recorded log
+    // can be replayed as is
+    void log_keys()
+    {
+      static constexpr const char* NAMES[] = {
+        "A", "B", "SELECT", "START", "RIGHT", "LEFT", "UP", "DOWN", "R", "L"
+      };
+
+      char line[64];
+      int length = 0;
+
+      for (int i = 0; i < 10; ++i)
+      {
+        if (held_mask & (1u << i))
+        {
+          line[length++] = ' ';
+
+          for (const char* name = NAMES[i]; *name; ++name)
+          {
+            line[length++] = *name;
+          }
+        }
+      }
+
+      line[length] = 0;
+      BN_LOG("[input] ", frame_count, line);
+    }
+#endif
+  }
+
+  void update()
+  {
+    ++frame_count;
+    previous_mask = held_mask;
+    held_mask = read_keys();
+
+#ifdef NEO_INPUT_RECORD
+    if (held_mask != previous_mask)
+    {
+      log_keys();
+    }
+#endif
+  }
+
+  int frame()
+  {
+    return frame_count;
+  }
+
+  unsigned held_keys()
+  {
+    return held_mask;
+  }
+
+  unsigned previous_keys()
+  {
+    return previous_mask;
+  }
+
+  unsigned pressed_keys()
+  {
+    return held_mask & ~previous_mask;
+  }
+
+  unsigned released_keys()
+  {
+    return previous_mask & ~held_mask;
+  }
+}
@@ -5,6 +5,7 @@
 
 #include "player.h"
 #include "game.h"
+#include "input.h"
 
 int main()
 {
@@ -12,13 +13,17 @@ int main()
 
   bn::camera_ptr camera = bn::camera_ptr::create(0, 0);
   neo::player player;
-  neo::game game(camera, player);
 
-  player.set_game(game);
+  // The game holds the object pools, too big for the IWRAM stack, so it
+  // is allocated once and lives for the whole program
+  neo::game* game = new neo::game(camera, player);
+
+  player.set_game(*game);
 
   while (true)
   {
-    game.run();
+    game->run();
     bn::core::update();
+    neo::input::update();
   }
 }
@@ -0,0 +1,82 @@
+#include <bn_core.h>
+
+#include "occupancy.h"
+#include "actor.h"
+
+namespace neo
+{
+  occupancy_grid::occupancy_grid()
+  {
+    clear();
+  }
+
+  void occupancy_grid::clear()
+  {
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+      buckets[i] = nullptr;
+    }
+  }
+
+  void occupancy_grid::add(neo::actor* actor, int tile_x, int tile_y)
+  {
+    if (actor->occupying)
+    {
+      remove(actor);
+    }
+
+    int index = bucket(tile_x, tile_y);
+    actor->cell_x = tile_x;
+    actor->cell_y = tile_y;
+    actor->next_in_cell = buckets[index];
+    actor->occupying = true;
+    buckets[index] = actor;
+  }
+
+  void occupancy_grid::remove(neo::actor* actor)
+  {
+    if (!actor->occupying)
+    {
+      return;
+    }
+
+    neo::actor** link = &buckets[bucket(actor->cell_x, actor->cell_y)];
+
+    while (*link != nullptr)
+    {
+      if (*link == actor)
+      {
+        *link = actor->next_in_cell;
+        break;
+      }
+
+      link = &(*link)->next_in_cell;
+    }
+
+    actor->next_in_cell = nullptr;
+    actor->occupying = false;
+  }
+
+  void occupancy_grid::move(neo::actor* actor, int tile_x, int tile_y)
+  {
+    if (actor->occupying && actor->cell_x == tile_x && actor->cell_y == tile_y)
+    {
+      return;
+    }
+
+    add(actor, tile_x, tile_y);
+  }
+
+  neo::actor* occupancy_grid::at(int tile_x, int tile_y) const
+  {
+    for (neo::actor* a = buckets[bucket(tile_x, tile_y)]; a != nullptr; a = a->next_in_cell)
+    {
+      if (a->cell_x == tile_x && a->cell_y == tile_y)
+      {
+        return a;
+      }
+    }
+
+    return nullptr;
+  }
+}
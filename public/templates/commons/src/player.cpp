@@ -1,9 +1,7 @@
 #include <bn_core.h>
-#include <bn_keypad.h>
 #include <bn_sprite_ptr.h>
 #include <bn_camera_actions.h>
 #include <bn_sprite_tiles_ptr.h>
-#include <bn_sprite_animate_actions.h>
 #include <bn_sprite_item.h>
 
 #include <bn_sprite_items_sprite_default.h>
@@ -12,6 +10,7 @@
 #include "player.h"
 #include "game.h"
 #include "commons.h"
+#include "input.h"
 
 namespace neo
 {
@@ -20,15 +19,22 @@ namespace neo
       tiles(bn::sprite_items::sprite_default.tiles_item()),
       position(0, 0),
       direction(neo::types::direction::DOWN),
-      map(nullptr)
+      map(nullptr),
+      moving(false),
+      move_delta(0),
+      target_tile_x(0),
+      target_tile_y(0)
   {
     sprite.set_visible(false);
     sprite.set_bg_priority(1);
     sprite.set_z_order(1);
   }
 
-  void player::play(neo::types::map& map_, int start_tile_x, int start_tile_y, int start_z, neo::types::direction start_direction, bn::sprite_ptr sprite_, bn::sprite_tiles_item tiles_)
+  void player::play(const neo::types::map& map_, int start_tile_x, int start_tile_y, int start_z, neo::types::direction start_direction, bn::sprite_ptr sprite_, bn::sprite_tiles_item tiles_)
   {
+    animation.stop();
+    moving = false;
+
     sprite = sprite_;
     sprite.set_bg_priority(1);
     sprite.set_z_order(start_z);
@@ -37,245 +43,294 @@ namespace neo
     tiles = tiles_;
 
     set_map(map_);
-    set_position(bn::fixed_point(map->to_pixel_x(game->variables, start_tile_x), map->to_pixel_y(game->variables, start_tile_y)));
+    game->camera_follow.setup(game->active_scene->camera_follow);
+    set_position(bn::fixed_point(game->map_metrics.to_pixel(start_tile_x), game->map_metrics.to_pixel(start_tile_y)));
 
-    direction = start_direction;
+    // Spawning inside a sensor doesn't trigger it, leaving it does
+    update_sensors(start_tile_x, start_tile_y, false);
 
-    if (start_direction == neo::types::direction::LEFT)
-    {
-        sprite.set_tiles(tiles.create_tiles(neo::tileindex::LEFT));
-        sprite.set_horizontal_flip(true);
-    }
-    else if (start_direction == neo::types::direction::RIGHT)
-    {
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::RIGHT));
-      sprite.set_horizontal_flip(false);
-    }
-    else if (start_direction == neo::types::direction::UP)
-    {
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::UP));
-    }
-    else
-    {
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::DOWN));
-    }
+    // No easing in on spawn
+    game->camera_follow.snap(game, (int)position.x() - game->map_metrics.half_pixel_width, (int)position.y() - game->map_metrics.half_pixel_height);
+
+    face(start_direction);
 
     sprite.set_visible(true);
   }
 
   void player::update()
   {
-    if (bn::keypad::a_pressed())
+    // Finish the current step before reading input again
+    if (moving)
+    {
+      move();
+      return;
+    }
+
+    // Keep walking while the same direction is held
+    if (animation.active())
+    {
+      if (direction_held())
+      {
+        walk();
+        return;
+      }
+
+      stop();
+    }
+
+    if (neo::input::pressed(neo::input::A))
     {
       neo::actor* actor = game->get_actor_at(
-        map->to_tile_x(game->variables, (int)position.x()),
-        map->to_tile_y(game->variables, (int)position.y()),
+        game->map_metrics.to_tile((int)position.x()),
+        game->map_metrics.to_tile((int)position.y()),
         direction
       );
 
-      if (actor != nullptr && game->active_scene != nullptr && actor->definition->interact_events != nullptr)
+      if (actor != nullptr && game->active_scene != nullptr && !actor->definition->interact_events.empty())
       {
         actor->set_direction(opposite_direction());
-        for (int i = 0; i < actor->definition->interact_events_count; i++)
-        {
-          game->exec_event(actor->definition->interact_events[i], true);
-        }
+        game->start_task(actor->definition->interact_events, true);
 
-        bn::core::update();
         return;
       }
     }
 
-    if (bn::keypad::left_pressed() || bn::keypad::left_held())
+    if (neo::input::pressed(neo::input::LEFT) || neo::input::held(neo::input::LEFT))
     {
       BN_LOG("Left key pressed/held");
-      direction = neo::types::direction::LEFT;
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::LEFT));
-      sprite.set_horizontal_flip(true);
+      face(neo::types::direction::LEFT);
 
-      if (bn::keypad::left_held())
+      if (neo::input::held(neo::input::LEFT))
       {
-        bn::sprite_animate_action<4> action = bn::create_sprite_animate_action_forever(
-          sprite,
-          ANIMATION_FPS,
-          tiles,
-          8, 2, 9, 2
-        );
-
-        while (bn::keypad::left_held())
-        {
-          move(action);
-        }
+        animation.start(neo::anims::LEFT, neo::anims::COUNT, ANIMATION_FPS);
 
-        action.reset();
-        sprite.set_tiles(tiles.create_tiles(neo::tileindex::LEFT));
+        walk();
+        return;
       }
     }
-    else if (bn::keypad::right_pressed() || bn::keypad::right_held())
+    else if (neo::input::pressed(neo::input::RIGHT) || neo::input::held(neo::input::RIGHT))
     {
       BN_LOG("Right key pressed/held");
-      direction = neo::types::direction::RIGHT;
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::RIGHT));
-      sprite.set_horizontal_flip(false);
+      face(neo::types::direction::RIGHT);
 
-      if (bn::keypad::right_held())
+      if (neo::input::held(neo::input::RIGHT))
       {
-        bn::sprite_animate_action<4> action = bn::create_sprite_animate_action_forever(
-          sprite,
-          ANIMATION_FPS,
-          tiles,
-          8, 2, 9, 2
-        );
-
-        while (bn::keypad::right_held())
-        {
-          move(action);
-        }
+        animation.start(neo::anims::RIGHT, neo::anims::COUNT, ANIMATION_FPS);
 
-        action.reset();
-        sprite.set_tiles(tiles.create_tiles(neo::tileindex::RIGHT));
+        walk();
+        return;
       }
     }
 
-    if (bn::keypad::up_pressed() || bn::keypad::up_held())
+    if (neo::input::pressed(neo::input::UP) || neo::input::held(neo::input::UP))
     {
       BN_LOG("Up key pressed/held");
-      direction = neo::types::direction::UP;
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::UP));
+      face(neo::types::direction::UP);
 
-      if (bn::keypad::up_held())
+      if (neo::input::held(neo::input::UP))
       {
-        bn::sprite_animate_action<4> action = bn::create_sprite_animate_action_forever(
-          sprite,
-          ANIMATION_FPS,
-          tiles,
-          6, 1, 7, 1
-        );
-
-        while (bn::keypad::up_held())
-        {
-          move(action);
-        }
+        animation.start(neo::anims::UP, neo::anims::COUNT, ANIMATION_FPS);
 
-        action.reset();
-        sprite.set_tiles(tiles.create_tiles(neo::tileindex::UP));
+        walk();
       }
     }
-    else if (bn::keypad::down_pressed() || bn::keypad::down_held())
+    else if (neo::input::pressed(neo::input::DOWN) || neo::input::held(neo::input::DOWN))
     {
       BN_LOG("Down key pressed/held");
-      direction = neo::types::direction::DOWN;
-      sprite.set_tiles(tiles.create_tiles(neo::tileindex::DOWN));
+      face(neo::types::direction::DOWN);
 
-      if (bn::keypad::down_held())
+      if (neo::input::held(neo::input::DOWN))
       {
-        bn::sprite_animate_action<4> action = bn::create_sprite_animate_action_forever(
-          sprite,
-          ANIMATION_FPS,
-          tiles,
-          4, 0, 5, 0
-        );
-
-        while (bn::keypad::down_held())
-        {
-          move(action);
-        }
+        animation.start(neo::anims::DOWN, neo::anims::COUNT, ANIMATION_FPS);
 
-        action.reset();
-        sprite.set_tiles(tiles.create_tiles(neo::tileindex::DOWN));
+        walk();
       }
     }
   }
 
-  void player::move(bn::sprite_animate_action<4>& action)
+  void player::walk()
   {
+    const neo::types::map_metrics& metrics = game->map_metrics;
     int next_x = (int)position.x();
     int next_y = (int)position.y();
 
     switch (direction)
     {
       case neo::types::direction::LEFT:
-        next_x -= map->grid_size->as_int(game->variables);
+        next_x -= metrics.grid_size;
         break;
       case neo::types::direction::RIGHT:
-        next_x += map->grid_size->as_int(game->variables);
+        next_x += metrics.grid_size;
         break;
       case neo::types::direction::UP:
-        next_y -= map->grid_size->as_int(game->variables);
+        next_y -= metrics.grid_size;
         break;
       default:
-        next_y += map->grid_size->as_int(game->variables);
+        next_y += metrics.grid_size;
         break;
     }
 
-    int tile_x = map->to_tile_x(game->variables, next_x);
-    int tile_y = map->to_tile_y(game->variables, next_y);
+    int tile_x = metrics.to_tile(next_x);
+    int tile_y = metrics.to_tile(next_y);
 
     if (map->has_collision(tile_x, tile_y) || game->has_collision(tile_x, tile_y))
     {
-      // action.update();
-      bn::core::update();
+      // Blocked, keep facing the wall while the key is held
+      return;
+    }
+
+    target_tile_x = tile_x;
+    target_tile_y = tile_y;
+    move_delta = 0;
+    moving = true;
+
+    move();
+  }
+
+  void player::move()
+  {
+    switch (direction)
+    {
+      case neo::types::direction::LEFT:
+        position.set_x(position.x() - PLAYER_SPEED);
+        break;
+      case neo::types::direction::RIGHT:
+        position.set_x(position.x() + PLAYER_SPEED);
+        break;
+      case neo::types::direction::UP:
+        position.set_y(position.y() - PLAYER_SPEED);
+        break;
+      default:
+        position.set_y(position.y() + PLAYER_SPEED);
+        break;
+    }
+
+    set_position(position);
+    move_delta += PLAYER_SPEED;
+
+    int graphics_index = animation.update();
 
+    if (graphics_index >= 0)
+    {
+      sprite.set_tiles(game->sprite_tiles.get(tiles, graphics_index));
+    }
+
+    if (move_delta < game->map_metrics.grid_size)
+    {
       return;
     }
 
-    int delta = 0;
+    moving = false;
+    update_sensors(target_tile_x, target_tile_y, game->active_scene != nullptr);
+  }
+
+  void player::update_sensors(int tile_x, int tile_y, bool trigger)
+  {
+    const neo::types::sensor* matches[MAX_SENSORS];
+    int count = map->get_sensors(tile_x, tile_y, matches, MAX_SENSORS);
 
-    while (delta < map->grid_size->as_int(game->variables))
+    if (trigger)
     {
-      switch (direction)
+      // Sensors that were left, in the order they were entered
+      for (const neo::types::sensor* active : active_sensors)
       {
-        case neo::types::direction::LEFT:
-          position.set_x(position.x() - PLAYER_SPEED);
-          break;
-        case neo::types::direction::RIGHT:
-          position.set_x(position.x() + PLAYER_SPEED);
-          break;
-        case neo::types::direction::UP:
-          position.set_y(position.y() - PLAYER_SPEED);
-          break;
-        default:
-          position.set_y(position.y() + PLAYER_SPEED);
-          break;
+        bool still_inside = false;
+
+        for (int i = 0; i < count && !still_inside; ++i)
+        {
+          still_inside = matches[i] == active;
+        }
+
+        if (!still_inside)
+        {
+          game->start_task(active->exit_events, true);
+        }
       }
 
-      set_position(position);
-      delta += PLAYER_SPEED;
-      action.update();
-      bn::core::update();
+      // Sensors that were entered, highest priority first
+      for (int i = 0; i < count; ++i)
+      {
+        bool was_inside = false;
+
+        for (const neo::types::sensor* active : active_sensors)
+        {
+          if (active == matches[i])
+          {
+            was_inside = true;
+            break;
+          }
+        }
+
+        if (!was_inside)
+        {
+          game->start_task(matches[i]->events, true);
+        }
+      }
     }
 
-    neo::types::sensor* sensor = map->get_sensor(tile_x, tile_y);
-    if (sensor != nullptr && game->active_scene != nullptr && sensor->events != nullptr)
+    active_sensors.clear();
+
+    for (int i = 0; i < count; ++i)
     {
-      for (int i = 0; i < sensor->events_count; i++)
-      {
-        game->exec_event(sensor->events[i], true);
-      }
+      active_sensors.push_back(matches[i]);
+    }
+  }
 
-      action.update();
-      bn::core::update();
+  void player::stop()
+  {
+    animation.stop();
+    face(direction);
+  }
 
-      return;
+  void player::face(neo::types::direction direction_)
+  {
+    direction = direction_;
+
+    switch (direction)
+    {
+      case neo::types::direction::LEFT:
+        sprite.set_tiles(game->sprite_tiles.get(tiles, neo::tileindex::LEFT));
+        sprite.set_horizontal_flip(true);
+        break;
+      case neo::types::direction::RIGHT:
+        sprite.set_tiles(game->sprite_tiles.get(tiles, neo::tileindex::RIGHT));
+        sprite.set_horizontal_flip(false);
+        break;
+      case neo::types::direction::UP:
+        sprite.set_tiles(game->sprite_tiles.get(tiles, neo::tileindex::UP));
+        break;
+      default:
+        sprite.set_tiles(game->sprite_tiles.get(tiles, neo::tileindex::DOWN));
+        break;
+    }
+  }
+
+  bool player::direction_held()
+  {
+    switch (direction)
+    {
+      case neo::types::direction::LEFT:
+        return neo::input::held(neo::input::LEFT);
+      case neo::types::direction::RIGHT:
+        return neo::input::held(neo::input::RIGHT);
+      case neo::types::direction::UP:
+        return neo::input::held(neo::input::UP);
+      default:
+        return neo::input::held(neo::input::DOWN);
     }
   }
 
   void player::set_position(bn::fixed_point position_)
   {
+    const neo::types::map_metrics& metrics = game->map_metrics;
+
     position = position_;
-    int x = (int)position.x() - map->pixel_width(game->variables) / 2;
-    int y = (int)position.y() - map->pixel_height(game->variables) / 2;
+    int x = (int)position.x() - metrics.half_pixel_width;
+    int y = (int)position.y() - metrics.half_pixel_height;
     sprite.set_x(x + width() / 2);
     sprite.set_y(y + height() / 2);
 
-    game->camera.set_x(bn::min(
-      bn::max(x, -(map->pixel_width(game->variables) / 2 - neo::types::SCREEN_WIDTH / 2)),
-      map->pixel_width(game->variables) / 2 - neo::types::SCREEN_WIDTH / 2
-    ));
-    game->camera.set_y(bn::min(
-      bn::max(y, -(map->pixel_height(game->variables) / 2 - neo::types::SCREEN_HEIGHT / 2)),
-      map->pixel_height(game->variables) / 2 - neo::types::SCREEN_HEIGHT / 2
-    ));
+    game->camera_follow.set_target(game, x, y);
   }
 
   void player::set_game(neo::game& game_)
@@ -283,7 +338,7 @@ namespace neo
     game = &game_;
   }
 
-  void player::set_map(neo::types::map& map_)
+  void player::set_map(const neo::types::map& map_)
   {
     map = &map_;
   }
@@ -0,0 +1,57 @@
+#include <bn_core.h>
+#include <bn_log.h>
+
+#include "scheduler.h"
+
+namespace neo
+{
+  void scheduler::clear()
+  {
+    head = 0;
+    count = 0;
+    blocking_count = 0;
+  }
+
+  bool scheduler::push(const neo::job& job)
+  {
+    if (count >= MAX_JOBS)
+    {
+      BN_LOG("Too many jobs, running one now");
+      job.run(job.context, job.argument);
+      return false;
+    }
+
+    jobs[(head + count) % MAX_JOBS] = job;
+    ++count;
+
+    if (job.blocking)
+    {
+      ++blocking_count;
+    }
+
+    return true;
+  }
+
+  int scheduler::drain(bn::fixed budget)
+  {
+    int ran = 0;
+
+    while (count > 0 && (ran == 0 || bn::core::current_cpu_usage() < budget))
+    {
+      // Popped first, a job can queue others
+      neo::job job = jobs[head];
+      head = (head + 1) % MAX_JOBS;
+      --count;
+
+      if (job.blocking)
+      {
+        --blocking_count;
+      }
+
+      job.run(job.context, job.argument);
+      ++ran;
+    }
+
+    return ran;
+  }
+}
@@ -13,7 +13,7 @@ namespace neo
 {
   sprite::sprite(
     neo::game* game_,
-    neo::types::sprite* sprite_definition_
+    const neo::types::sprite* sprite_definition_
   ): game(game_),
       definition(sprite_definition_),
       inner_sprite(definition->sprite.create_sprite(0, 0))
@@ -39,11 +39,12 @@ namespace neo
   {
     position = bn::fixed_point(tile_x, tile_y);
 
-    int x = game->active_scene->map_data->to_pixel_x(game->variables, tile_x)
-        - game->active_scene->map_data->pixel_width(game->variables) / 2
+    const neo::types::map_metrics& metrics = game->map_metrics;
+    int x = metrics.to_pixel(tile_x)
+        - metrics.half_pixel_width
         + inner_sprite.dimensions().width() / 2;
-    int y = game->active_scene->map_data->to_pixel_y(game->variables, tile_y)
-        - game->active_scene->map_data->pixel_height(game->variables) / 2
+    int y = metrics.to_pixel(tile_y)
+        - metrics.half_pixel_height
         + inner_sprite.dimensions().height() / 2;
 
     inner_sprite.set_x(x);
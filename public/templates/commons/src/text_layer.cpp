@@ -0,0 +1,107 @@
+#include <bn_core.h>
+#include <bn_log.h>
+#include <bn_math.h>
+#include <bn_size.h>
+#include <bn_bg_palette_ptr.h>
+#include <bn_regular_bg_tiles_ptr.h>
+#include <bn_regular_bg_map_cell_info.h>
+
+#include <bn_bg_palette_items_gbs_mono_palette.h>
+#include <bn_regular_bg_tiles_items_gbs_mono_tiles.h>
+
+#include "text_layer.h"
+
+namespace neo
+{
+  namespace
+  {
+    bn::regular_bg_map_cell glyph_cell(int glyph)
+    {
+      bn::regular_bg_map_cell_info info;
+      info.set_tile_index(glyph);
+
+      return info.cell();
+    }
+  }
+
+  void text_layer::load()
+  {
+    BN_LOG("Loading text layer font");
+
+    map = bn::regular_bg_map_ptr::allocate(
+      bn::size(COLUMNS, ROWS),
+      bn::regular_bg_tiles_items::gbs_mono_tiles.create_tiles(),
+      bn::bg_palette_items::gbs_mono_palette.create_palette()
+    );
+
+    // Allocated maps aren't cleared
+    const bn::regular_bg_map_cell blank = glyph_cell(0);
+
+    for (int row = 0; row < ROWS; ++row)
+    {
+      for (int column = 0; column < COLUMNS; ++column)
+      {
+        map->set_cell(column, row, blank);
+      }
+    }
+
+    bg = bn::regular_bg_ptr::create(*map);
+
+    // Above the textbox, which has the same priority
+    bg->set_z_order(-1);
+  }
+
+  void text_layer::show(int x, int y, int priority)
+  {
+    if (!bg.has_value())
+    {
+      load();
+    }
+
+    bg->set_priority(priority);
+    bg->set_top_left_position(x, y);
+    bg->set_visible(true);
+  }
+
+  void text_layer::hide()
+  {
+    if (bg.has_value())
+    {
+      clear();
+      bg->set_visible(false);
+    }
+  }
+
+  void text_layer::clear()
+  {
+    if (!map.has_value())
+    {
+      return;
+    }
+
+    const bn::regular_bg_map_cell blank = glyph_cell(0);
+
+    for (int row = 0; row < used_rows; ++row)
+    {
+      for (int column = 0; column < used_columns; ++column)
+      {
+        map->set_cell(column, row, blank);
+      }
+    }
+
+    used_columns = 0;
+    used_rows = 0;
+  }
+
+  void text_layer::put(int column, int row, int glyph)
+  {
+    if (!map.has_value() || column < 0 || column >= COLUMNS || row < 0 || row >= ROWS)
+    {
+      return;
+    }
+
+    map->set_cell(column, row, glyph_cell(glyph));
+    used_columns = bn::max(used_columns, column + 1);
+    used_rows = bn::max(used_rows, row + 1);
+  }
+}
@@ -0,0 +1,52 @@
+#include <bn_core.h>
+#include <bn_log.h>
+
+#include "tile_cache.h"
+
+namespace neo
+{
+  bn::sprite_tiles_ptr tile_cache::get(const bn::sprite_tiles_item& item, int graphics_index)
+  {
+    if (graphics_index < 0 || graphics_index >= MAX_GRAPHICS)
+    {
+      return item.create_tiles(graphics_index);
+    }
+
+    entry* found = nullptr;
+
+    for (entry& e : entries)
+    {
+      if (e.item == item)
+      {
+        found = &e;
+        break;
+      }
+    }
+
+    if (found == nullptr)
+    {
+      if (entries.full())
+      {
+        BN_LOG("Tile cache is full, tiles are not shared");
+        return item.create_tiles(graphics_index);
+      }
+
+      entries.push_back({ item, {} });
+      found = &entries.back();
+    }
+
+    bn::optional<bn::sprite_tiles_ptr>& tiles = found->graphics[graphics_index];
+
+    if (!tiles.has_value())
+    {
+      tiles = item.create_tiles(graphics_index);
+    }
+
+    return *tiles;
+  }
+
+  void tile_cache::clear()
+  {
+    entries.clear();
+  }
+}
@@ -0,0 +1,61 @@
+#include <bn_core.h>
+#include <bn_log.h>
+
+#include "watchers.h"
+#include "code.h"
+
+namespace neo::watchers
+{
+  bool passes(const neo::types::variable_event& handler, int value)
+  {
+    switch ((neo::code::comparison)handler.comparison)
+    {
+      case neo::code::comparison::EQUAL:
+        return value == handler.value;
+      case neo::code::comparison::NOT_EQUAL:
+        return value != handler.value;
+      case neo::code::comparison::LESS:
+        return value < handler.value;
+      case neo::code::comparison::LESS_EQUAL:
+        return value <= handler.value;
+      case neo::code::comparison::GREATER:
+        return value > handler.value;
+      case neo::code::comparison::GREATER_EQUAL:
+        return value >= handler.value;
+      default:
+        return true;
+    }
+  }
+
+  void dispatcher::clear()
+  {
+    handlers.clear();
+
+    for (bool& slot : watched)
+    {
+      slot = false;
+    }
+  }
+
+  void dispatcher::add(const neo::types::variable_event& handler)
+  {
+    // Lists that run again (actor updates, scripts) reach the same
+    // handler more than once, it is only registered the first time
+    for (const neo::types::variable_event& other : handlers)
+    {
+      if (other.events.code == handler.events.code)
+      {
+        return;
+      }
+    }
+
+    if (handlers.full())
+    {
+      BN_LOG("Too many variable handlers, ignoring one");
+      return;
+    }
+
+    handlers.push_back(handler);
+    watched[handler.slot] = true;
+  }
+}
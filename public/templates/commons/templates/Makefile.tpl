@@ -19,3 +19,29 @@ ifndef LIBBUTANOABS
 endif
 
 include $(LIBBUTANOABS)/butano.mak
+
+# Benchmark: builds a separate ROM sampling the CPU usage of each frame,
+# then replays BENCH_INPUT in a headless mGBA for BENCH_FRAMES frames
+BENCH_FRAMES ?= 3600
+BENCH_INPUT  ?= {{posix benchInput}}
+MGBA         ?= mgba-qt
+
+.PHONY: bench
+bench:
+	@$(MAKE) --no-print-directory BUILD=build_bench TARGET=$(TARGET)_bench USERFLAGS="$(USERFLAGS) -DNEO_BENCH_FRAMES=$(BENCH_FRAMES)"
+	@$(PYTHON) {{posix benchScript}} --rom $(TARGET)_bench.gba --frames $(BENCH_FRAMES) --input $(BENCH_INPUT) --mgba $(MGBA) --report bench.json
+
+# Input recording: builds a ROM logging every change of the held keys as
+# "[input] <frame> <keys>", save the emulator log to replay the session
+.PHONY: record
+record:
+	@$(MAKE) --no-print-directory BUILD=build_record TARGET=$(TARGET)_record USERFLAGS="$(USERFLAGS) -DNEO_INPUT_RECORD"
+
+# Input replay: builds a ROM ignoring the keypad and playing back
+# REPLAY_INPUT (an input script or a recorded log) frame by frame
+REPLAY_INPUT ?= $(BENCH_INPUT)
+
+.PHONY: replay
+replay:
+	@$(PYTHON) {{posix replayScript}} --input $(REPLAY_INPUT) --output build_replay/replay/neo_replay.h
+	@$(MAKE) --no-print-directory BUILD=build_replay TARGET=$(TARGET)_replay USERFLAGS="$(USERFLAGS) -DNEO_INPUT_REPLAY -I$(CURDIR)/build_replay/replay"
@@ -3,8 +3,6 @@
 
 #include <bn_core.h>
 #include <bn_regular_bg_ptr.h>
-#include <bn_vector.h>
-#include <bn_unique_ptr.h>
 
 #include "neo_types.h"
 
@@ -27,32 +25,25 @@
 
 namespace neo::scenes
 {
-  constexpr bn::string_view STARTING_SCENE = "{{valuedef project.startingScene scenes.[0].id}}";
+  // Scene ids are indexes in SCENES, resolved when the templates are built
+  constexpr int SCENES_COUNT = {{size scenes}};
+  constexpr int DEFAULT_SCENE = SCENES_COUNT;
+  constexpr int STARTING_SCENE = {{#with (itemIndex scenes (valuedef project.startingScene scenes.[0].id)) as | index |}}{{#if (gte index 0)}}{{index}}{{else}}DEFAULT_SCENE{{/if}}{{/with}};
 
-  bn::vector<bn::string_view, 10> make_button_vector()
+  /**
+   * FNV-1a, only used to look up names that are not known at build time.
+   * The seed of each table is picked by the build so there are no collisions.
+   */
+  constexpr unsigned hash(bn::string_view str, unsigned seed)
   {
-    return bn::vector<bn::string_view, 10>();
-  }
+    unsigned h = 2166136261u ^ seed;
 
-  template<typename... Args>
-  bn::vector<bn::string_view, 10> make_button_vector(Args... buttons)
-  {
-    bn::vector<bn::string_view, 10> vec;
-    ((vec.push_back(buttons)), ...);
-    return vec;
-  }
+    for (char c : str)
+    {
+      h = (h ^ (unsigned char)c) * 16777619u;
+    }
 
-  bn::vector<bn::string_view, 5> make_dialog_vector()
-  {
-    return bn::vector<bn::string_view, 5>();
-  }
-
-  template<typename... Args>
-  bn::vector<bn::string_view, 5> make_dialog_vector(Args... lines)
-  {
-    bn::vector<bn::string_view, 5> vec;
-    ((vec.push_back(lines)), ...);
-    return vec;
+    return h;
   }
 
   {{#each scenes}}
@@ -61,20 +52,22 @@ namespace neo::scenes
   //////////////////////////
 
   // Scene Events
-  {{#if (hasItems this.events)}}
-  {{>eventsPartial prefix=(concat (slug this.name) "_event") events=this.events}}
-  neo::types::event* {{slug this.name}}_events[] = {
-    {{#each this.events}}
-    &{{slug ../this.name}}_event_{{@index}},
+  {{>eventsPartial name=(concat (slug this.name) "_events") events=this.events}}
+
+  // Map collisions, 1 bit per tile
+  {{#if this.map}}
+  {{#if (hasItems this.map.collisions)}}
+  constexpr unsigned {{slug this.name}}_map_collisions[] = {
+    {{#each (packTiles this.map.collisions this.map.width this.map.height 1)}}
+    {{this}}{{#unless @last}},{{/unless}}
     {{/each}}
   };
   {{/if}}
 
-  // Map collisions
-  {{#if this.map}}
-  {{#if (hasItems this.map.collisions)}}
-  constexpr int {{slug this.name}}_map_collisions[{{multiply (valuedef this.map.width 0) (valuedef this.map.height 0)}}] = {
-    {{#each this.map.collisions}}
+  // Map attributes, 4 bits per tile
+  {{#if (hasItems this.map.attributes)}}
+  constexpr unsigned {{slug this.name}}_map_attributes[] = {
+    {{#each (packTiles this.map.attributes this.map.width this.map.height 4)}}
     {{this}}{{#unless @last}},{{/unless}}
     {{/each}}
   };
@@ -84,43 +77,52 @@ namespace neo::scenes
   {{#if (hasItems this.map.sensors)}}
   {{#each this.map.sensors}}
   // -- Sensor events
-  {{#if (hasItems this.events)}}
-  {{>eventsPartial prefix=(concat (slug ../this.name) "_sensor_" @index "_event") events=this.events}}
-  {{/if}}
-  neo::types::event* {{slug ../this.name}}_sensor_{{@index}}_events[] = {
-    {{#each this.events}}
-    &{{slug ../../this.name}}_sensor_{{@../index}}_event_{{@index}},
-    {{/each}}
-  };
+  {{>eventsPartial name=(concat (slug ../this.name) "_sensor_" @index "_events") events=this.events}}
+
+  // -- Sensor exit events
+  {{>eventsPartial name=(concat (slug ../this.name) "_sensor_" @index "_exit_events") events=this.exitEvents}}
 
   // -- Sensor
-  bn::string_view {{slug ../this.name}}_sensor_{{@index}}_id = "{{this.id}}";
-  neo::types::sensor {{slug ../this.name}}_sensor_{{@index}} = {
+  constexpr bn::string_view {{slug ../this.name}}_sensor_{{@index}}_id = "{{this.id}}";
+  constexpr neo::types::sensor {{slug ../this.name}}_sensor_{{@index}} = {
     {{slug ../this.name}}_sensor_{{@index}}_id,
     {{this.x}},
     {{this.y}},
     {{valuedef this.width 1}},
     {{valuedef this.height 1}},
-    {{valuedef this.events.length 0}},
-    {{#if (hasItems this.events)}}
-    {{slug ../this.name}}_sensor_{{@index}}_events
-    {{else}}
-    nullptr
-    {{/if}}
+    {{valuedef this.priority 0}},
+    {{slug ../this.name}}_sensor_{{@index}}_events,
+    {{slug ../this.name}}_sensor_{{@index}}_exit_events
   };
   {{/each}}
 
-  neo::types::sensor* {{slug this.name}}_map_sensors[] = {
+  constexpr const neo::types::sensor* {{slug this.name}}_map_sensors[] = {
     {{#each this.map.sensors}}
     &{{slug ../this.name}}_sensor_{{@index}}{{#unless @last}},{{/unless}}
     {{/each}}
   };
+
+  // -- Sensors by map row
+  {{#with (sensorRows this.map.sensors this.map.height) as | index |}}
+  constexpr unsigned short {{slug ../this.name}}_map_sensor_rows[] = {
+    {{#each index.offsets}}
+    {{this}}{{#unless @last}},{{/unless}}
+    {{/each}}
+  };
+
+  constexpr unsigned short {{slug ../this.name}}_map_sensor_row_items[] = {
+    {{#each index.items}}
+    {{this}},
+    {{else}}
+    0
+    {{/each}}
+  };
+  {{/with}}
   {{/if}}
 
   // Map
   {{>valuePartial prefix=(concat (slug this.name) "_map_grid_size") value=(valuedef this.map.gridSize 16)}}
-  neo::types::map {{slug this.name}}_map_data = {
-    {{#if this.map}}
+  constexpr neo::types::map {{slug this.name}}_map_data = {
     {{valuedef this.map.width 0}},
     {{valuedef this.map.height 0}},
     &{{slug this.name}}_map_grid_size_value,
@@ -129,14 +131,18 @@ namespace neo::scenes
     {{else}}
     nullptr,
     {{/if}}
+    {{#if (hasItems this.map.attributes)}}
+    {{slug this.name}}_map_attributes,
     {{else}}
-    0, 0, 0, nullptr,
+    nullptr,
     {{/if}}
     {{#if (hasItems this.map.sensors)}}
     {{this.map.sensors.length}},
-    {{slug this.name}}_map_sensors
+    {{slug this.name}}_map_sensors,
+    {{slug this.name}}_map_sensor_rows,
+    {{slug this.name}}_map_sensor_row_items
     {{else}}
-    0, nullptr
+    0, nullptr, nullptr, nullptr
     {{/if}}
   };
   {{/if}}
@@ -145,36 +151,15 @@ namespace neo::scenes
   // Actors
   {{#each this.actors}}
   // -- Actor events
-  {{#if (hasItems this.events.init)}}
-  {{>eventsPartial prefix=(concat (slug ../this.name) "_actor_" @index "_init_event") events=this.events.init}}
-  neo::types::event* {{slug ../this.name}}_actor_{{@index}}_init_events[] = {
-    {{#each this.events.init}}
-    &{{slug ../../this.name}}_actor_{{@../index}}_init_event_{{@index}},
-    {{/each}}
-  };
-  {{/if}}
-  {{#if (hasItems this.events.interact)}}
-  {{>eventsPartial prefix=(concat (slug ../this.name) "_actor_" @index "_interact_event") events=this.events.interact}}
-  neo::types::event* {{slug ../this.name}}_actor_{{@index}}_interact_events[] = {
-    {{#each this.events.interact}}
-    &{{slug ../../this.name}}_actor_{{@../index}}_interact_event_{{@index}},
-    {{/each}}
-  };
-  {{/if}}
-  {{#if (hasItems this.events.update)}}
-  {{>eventsPartial prefix=(concat (slug ../this.name) "_actor_" @index "_update_event") events=this.events.update}}
-  neo::types::event* {{slug ../this.name}}_actor_{{@index}}_update_events[] = {
-    {{#each this.events.update}}
-    &{{slug ../../this.name}}_actor_{{@../index}}_update_event_{{@index}},
-    {{/each}}
-  };
-  {{/if}}
+  {{>eventsPartial name=(concat (slug ../this.name) "_actor_" @index "_init_events") events=this.events.init}}
+  {{>eventsPartial name=(concat (slug ../this.name) "_actor_" @index "_interact_events") events=this.events.interact}}
+  {{>eventsPartial name=(concat (slug ../this.name) "_actor_" @index "_update_events") events=this.events.update}}
   {{>valuePartial prefix=(concat (slug ../this.name) "_actor_" @index "_x") value=(valuedef this.x 0)}}
   {{>valuePartial prefix=(concat (slug ../this.name) "_actor_" @index "_y") value=(valuedef this.y 0)}}
   {{>valuePartial prefix=(concat (slug ../this.name) "_actor_" @index "_z") value=(valuedef this.z 2)}}
-  bn::string_view {{slug ../this.name}}_actor_{{@index}}_id = "{{this.id}}";
-  bn::string_view {{slug ../this.name}}_actor_{{@index}}_name = "{{this.name}}";
-  neo::types::actor {{slug ../this.name}}_actor_{{@index}} = {
+  constexpr bn::string_view {{slug ../this.name}}_actor_{{@index}}_id = "{{this.id}}";
+  constexpr bn::string_view {{slug ../this.name}}_actor_{{@index}}_name = "{{this.name}}";
+  constexpr neo::types::actor {{slug ../this.name}}_actor_{{@index}} = {
     {{slug ../this.name}}_actor_{{@index}}_id,
     {{slug ../this.name}}_actor_{{@index}}_name,
     &{{slug ../this.name}}_actor_{{@index}}_x_value,
@@ -182,30 +167,12 @@ namespace neo::scenes
     &{{slug ../this.name}}_actor_{{@index}}_z_value,
     neo::types::direction::{{uppercase (valuedef this.direction "down")}},
     bn::sprite_items::{{valuedef this.sprite "sprite_default"}},
-    {{#if (hasItems this.events.init)}}
-    {{this.events.init.length}},
     {{slug ../this.name}}_actor_{{@index}}_init_events,
-    {{else}}
-    0,
-    nullptr,
-    {{/if}}
-    {{#if (hasItems this.events.interact)}}
-    {{this.events.interact.length}},
     {{slug ../this.name}}_actor_{{@index}}_interact_events,
-    {{else}}
-    0,
-    nullptr,
-    {{/if}}
-    {{#if (hasItems this.events.update)}}
-    {{this.events.update.length}},
     {{slug ../this.name}}_actor_{{@index}}_update_events
-    {{else}}
-    0,
-    nullptr
-    {{/if}}
   };
   {{/each}}
-  neo::types::actor* {{slug this.name}}_actors[] = {
+  constexpr const neo::types::actor* {{slug this.name}}_actors[] = {
     {{#each this.actors}}
     &{{slug ../this.name}}_actor_{{@index}}{{#unless @last}},{{/unless}}
     {{/each}}
@@ -218,9 +185,9 @@ namespace neo::scenes
   {{>valuePartial prefix=(concat (slug ../this.name) "_sprite_" @index "_x") value=(valuedef this.x 0)}}
   {{>valuePartial prefix=(concat (slug ../this.name) "_sprite_" @index "_y") value=(valuedef this.y 0)}}
   {{>valuePartial prefix=(concat (slug ../this.name) "_sprite_" @index "_z") value=(valuedef this.z 2)}}
-  bn::string_view {{slug ../this.name}}_sprite_{{@index}}_id = "{{this.id}}";
-  bn::string_view {{slug ../this.name}}_sprite_{{@index}}_name = "{{this.name}}";
-  neo::types::sprite {{slug ../this.name}}_sprite_{{@index}} = {
+  constexpr bn::string_view {{slug ../this.name}}_sprite_{{@index}}_id = "{{this.id}}";
+  constexpr bn::string_view {{slug ../this.name}}_sprite_{{@index}}_name = "{{this.name}}";
+  constexpr neo::types::sprite {{slug ../this.name}}_sprite_{{@index}} = {
     {{slug ../this.name}}_sprite_{{@index}}_id,
     {{slug ../this.name}}_sprite_{{@index}}_name,
     &{{slug ../this.name}}_sprite_{{@index}}_x_value,
@@ -229,7 +196,7 @@ namespace neo::scenes
     bn::sprite_items::{{valuedef this.sprite "sprite_default"}}
   };
   {{/each}}
-  neo::types::sprite* {{slug this.name}}_sprites[] = {
+  constexpr const neo::types::sprite* {{slug this.name}}_sprites[] = {
     {{#each this.sprites}}
     &{{slug ../this.name}}_sprite_{{@index}}{{#unless @last}},{{/unless}}
     {{/each}}
@@ -240,9 +207,9 @@ namespace neo::scenes
   {{>valuePartial prefix=(concat (slug this.name) "_player_x") value=(valuedef this.player.x 0)}}
   {{>valuePartial prefix=(concat (slug this.name) "_player_y") value=(valuedef this.player.y 0)}}
   {{>valuePartial prefix=(concat (slug this.name) "_player_z") value=(valuedef this.player.z 1)}}
-  bn::string_view {{slug this.name}}_scene_id = "{{this.id}}";
-  bn::string_view {{slug this.name}}_scene_name = "{{this.name}}";
-  neo::types::scene scene_{{slug this.name}} = {
+  constexpr bn::string_view {{slug this.name}}_scene_id = "{{this.id}}";
+  constexpr bn::string_view {{slug this.name}}_scene_name = "{{this.name}}";
+  constexpr neo::types::scene scene_{{slug this.name}} = {
     {{slug this.name}}_scene_id,
     {{slug this.name}}_scene_name,
     {{#if this.background}}
@@ -250,13 +217,7 @@ namespace neo::scenes
     {{else}}
     bn::regular_bg_items::bg_default,
     {{/if}}
-    {{#if (hasItems this.events)}}
-    {{this.events.length}},
     {{slug this.name}}_events,
-    {{else}}
-    0,
-    nullptr,
-    {{/if}}
     {{#if this.player}}
     true,
     &{{slug this.name}}_player_x_value,
@@ -264,6 +225,7 @@ namespace neo::scenes
     &{{slug this.name}}_player_z_value,
     neo::types::direction::{{uppercase (valuedef this.player.direction 'down')}},
     bn::sprite_items::{{valuedef this.player.sprite "sprite_default"}},
+    { {{int this.player.camera.deadzoneX}}, {{int this.player.camera.deadzoneY}}, {{int (valuedef this.player.camera.lerp 100)}} },
     {{else}}
     false,
     &{{slug this.name}}_player_x_value,
@@ -271,6 +233,7 @@ namespace neo::scenes
     &{{slug this.name}}_player_z_value,
     neo::types::direction::DOWN,
     bn::sprite_items::sprite_default,
+    { 0, 0, 100 },
     {{/if}}
     {{#if this.map}}
     &{{slug this.name}}_map_data,
@@ -299,20 +262,20 @@ namespace neo::scenes
   {{>valuePartial prefix="default_player_x" value="0"}}
   {{>valuePartial prefix="default_player_y" value="0"}}
   {{>valuePartial prefix="default_player_z" value="1"}}
-  bn::string_view default_scene_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
-  bn::string_view default_scene_name = "default";
-  neo::types::scene scene_default = {
+  constexpr bn::string_view default_scene_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
+  constexpr bn::string_view default_scene_name = "default";
+  constexpr neo::types::scene scene_default = {
     default_scene_id,
     default_scene_name,
     bn::regular_bg_items::bg_default,
-    0,
-    nullptr,
+    { nullptr, 0 },
     false,
     &default_player_x_value,
     &default_player_y_value,
     &default_player_z_value,
     neo::types::direction::DOWN,
     bn::sprite_items::sprite_default,
+    { 0, 0, 100 },
     nullptr,
     0,
     nullptr,
@@ -320,58 +283,89 @@ namespace neo::scenes
     nullptr
   };
 
-  neo::types::scene get_scene(bn::string_view name)
-  {
-    if (name == "") return scene_default;
+  constexpr const neo::types::scene* SCENES[] = {
     {{#each scenes}}
-    if (name == "{{this.name}}" || name == "{{this.id}}") return scene_{{slug this.name}};
+    &scene_{{slug this.name}},
     {{/each}}
-    return scene_default;
+    &scene_default
+  };
+
+  {{#with (perfectHash scenes) as | table |}}
+  constexpr unsigned SCENES_HASH_SEED = {{table.seed}};
+  constexpr int SCENES_HASH_SIZE = {{table.size}};
+  constexpr int SCENES_HASH[] = {
+    {{#each table.slots}}
+    {{this}}{{#unless @last}},{{/unless}}
+    {{/each}}
+  };
+  {{/with}}
+
+  inline const neo::types::scene* get_scene(int id)
+  {
+    if (id < 0 || id >= SCENES_COUNT) return &scene_default;
+    return SCENES[id];
+  }
+
+  inline int find_scene(bn::string_view name)
+  {
+    int id = SCENES_HASH[hash(name, SCENES_HASH_SEED) & (SCENES_HASH_SIZE - 1)];
+    if (id != -1 && SCENES[id]->is(name)) return id;
+    return DEFAULT_SCENE;
   }
 
   // Scripts
   {{#each scripts}}
-  {{#if (hasItems this.events)}}
-  {{>eventsPartial prefix=(concat (slug this.name) "_script_event") events=this.events}}
-  neo::types::event* {{slug this.name}}_script_events[] = {
-    {{#each this.events}}
-    &{{slug ../this.name}}_script_event_{{@index}},
-    {{/each}}
-  };
-  {{/if}}
-  bn::string_view {{slug this.name}}_script_id = "{{this.id}}";
-  bn::string_view {{slug this.name}}_script_name = "{{this.name}}";
-  neo::types::script script_{{slug this.name}} = {
+  {{>eventsPartial name=(concat (slug this.name) "_script_events") events=this.events}}
+  constexpr bn::string_view {{slug this.name}}_script_id = "{{this.id}}";
+  constexpr bn::string_view {{slug this.name}}_script_name = "{{this.name}}";
+  constexpr neo::types::script script_{{slug this.name}} = {
     {{slug this.name}}_script_id,
     {{slug this.name}}_script_name,
-    {{#if (hasItems this.events)}}
-    {{this.events.length}},
     {{slug this.name}}_script_events
-    {{else}}
-    0,
-    nullptr
-    {{/if}}
   };
   {{/each}}
 
   // Default script
-  bn::string_view script_default_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
-  bn::string_view script_default_name = "default";
-  neo::types::script script_default = {
+  constexpr bn::string_view script_default_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
+  constexpr bn::string_view script_default_name = "default";
+  constexpr neo::types::script script_default = {
     script_default_id,
     script_default_name,
-    0,
-    nullptr
+    { nullptr, 0 }
   };
 
-  neo::types::script get_script(bn::string_view name)
-  {
-    if (name == "") return script_default;
+  // Script ids are indexes in SCRIPTS, resolved when the templates are built
+  constexpr int SCRIPTS_COUNT = {{size (ensureArray scripts)}};
+  constexpr int DEFAULT_SCRIPT = SCRIPTS_COUNT;
+
+  constexpr const neo::types::script* SCRIPTS[] = {
     {{#each scripts}}
-    if (name == "{{this.name}}" || name == "{{this.id}}") return script_{{slug this.name}};
+    &script_{{slug this.name}},
     {{/each}}
+    &script_default
+  };
 
-    return script_default;
+  {{#with (perfectHash scripts) as | table |}}
+  constexpr unsigned SCRIPTS_HASH_SEED = {{table.seed}};
+  constexpr int SCRIPTS_HASH_SIZE = {{table.size}};
+  constexpr int SCRIPTS_HASH[] = {
+    {{#each table.slots}}
+    {{this}}{{#unless @last}},{{/unless}}
+    {{/each}}
+  };
+  {{/with}}
+
+  inline const neo::types::script* get_script(int id)
+  {
+    if (id < 0 || id >= SCRIPTS_COUNT) return &script_default;
+    return SCRIPTS[id];
+  }
+
+  inline int find_script(bn::string_view name)
+  {
+    int id = SCRIPTS_HASH[hash(name, SCRIPTS_HASH_SEED) & (SCRIPTS_HASH_SIZE - 1)];
+    if (id != -1 && SCRIPTS[id]->is(name)) return id;
+    return DEFAULT_SCRIPT;
   }
 }
 
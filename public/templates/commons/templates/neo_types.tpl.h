@@ -3,10 +3,10 @@
 
 #include <bn_core.h>
 #include <bn_log.h>
+#include <bn_math.h>
 #include <bn_regular_bg_ptr.h>
 #include <bn_regular_bg_item.h>
 #include <bn_sprite_item.h>
-#include <bn_vector.h>
 
 #include <neo_variables.h>
 
@@ -15,6 +15,10 @@ namespace neo::types
   static constexpr int SCREEN_WIDTH = 240;
   static constexpr int SCREEN_HEIGHT = 160;
 
+  // Pool capacities, the most any single scene of the project needs
+  static constexpr int MAX_SCENE_ACTORS = {{maxItems scenes "actors"}};
+  static constexpr int MAX_SCENE_SPRITES = {{maxItems scenes "sprites"}};
+
   enum class direction
   {
     LEFT,
@@ -23,281 +27,129 @@ namespace neo::types
     DOWN
   };
 
-  struct event_value
+  enum class easing
   {
-    bn::string_view type;
-    neo::variables::value* value;
-
-    event_value(bn::string_view type_, neo::variables::value* value_):
-      type(type_), value(value_) {}
-
-    inline int as_int(neo::variables::registry& variables) const
-    {
-      if (type == "variable")
-      {
-        if (!variables.has(value->as_string()))
-        {
-          BN_LOG("Variable not found: ", value->as_string());
-          return 0;
-        }
-
-        neo::variables::value& var_value = variables.get(value->as_string());
-        return var_value.as_int();
-      }
-      else
-      {
-        return value->as_int();
-      }
-    }
-
-    inline bool as_bool(neo::variables::registry& variables) const
-    {
-      if (type == "variable")
-      {
-        if (!variables.has(value->as_string()))
-        {
-          BN_LOG("Variable not found: ", value->as_string());
-          return false;
-        }
-
-        neo::variables::value& var_value = variables.get(value->as_string());
-        return var_value.as_bool();
-      }
-      else
-      {
-        return value->as_bool();
-      }
-    }
-
-    inline bn::string_view as_string(neo::variables::registry& variables) const
-    {
-      if (type == "variable")
-      {
-        if (!variables.has(value->as_string()))
-        {
-          BN_LOG("Variable not found: ", value->as_string());
-          return "";
-        }
-
-        neo::variables::value& var_value = variables.get(value->as_string());
-        return var_value.as_string();
-      }
-      else
-      {
-        return value->as_string();
-      }
-    }
+    LINEAR,
+    EASE_IN,
+    EASE_OUT,
+    EASE_IN_OUT,
+    SMOOTHSTEP
   };
 
-  struct event
+  enum class button_trigger
   {
-    bn::string_view type;
+    PRESSED,
+    HELD,
+    RELEASED
   };
 
-  struct wait_event: event
+  /**
+   * Opcodes of the compiled events, must match OPCODES in events.ts
+   */
+  enum class event_type
   {
-    event_value* duration;
-    wait_event(bn::string_view type_, event_value* duration_):
-      event(type_), duration(duration_) {}
+    UNKNOWN = 0,
+    WAIT = 1,
+    FADE_IN = 2,
+    FADE_OUT = 3,
+    WAIT_FOR_BUTTON = 4,
+    ON_BUTTON_PRESS = 5,
+    GO_TO_SCENE = 6,
+    SHOW_DIALOG = 7,
+    SET_VARIABLE = 8,
+    IF = 9,
+    DISABLE_ACTOR = 10,
+    ENABLE_ACTOR = 11,
+    PLAY_MUSIC = 12,
+    STOP_MUSIC = 13,
+    PLAY_SOUND = 14,
+    EXECUTE_SCRIPT = 15,
+    MOVE_CAMERA_TO = 16,
+    JUMP = 17, // Over the else branch of an if
+    ADD_VARIABLE = 18,
+    SUBTRACT_VARIABLE = 19,
+    MULTIPLY_VARIABLE = 20,
+    CLAMP_VARIABLE = 21,
+    RANDOM_VARIABLE = 22,
+    ON_VARIABLE_CHANGE = 23
   };
 
-  struct fade_event: event
+  struct event_value
   {
-    event_value* duration;
-    fade_event(bn::string_view type_, event_value* duration_):
-      event(type_), duration(duration_) {}
-  };
+    int slot; // Variable slot, or -1 for a raw value
+    int value;
 
-  struct scene_event: event
-  {
-    bn::string_view target;
-    event_value* start_x;
-    event_value* start_y;
-    neo::types::direction start_direction;
-    scene_event(bn::string_view type_, bn::string_view target_, event_value* start_x_, event_value* start_y_, neo::types::direction start_direction_):
-      event(type_), target(target_), start_x(start_x_), start_y(start_y_), start_direction(start_direction_) {}
-  };
+    constexpr event_value(int slot_, int value_):
+      slot(slot_), value(value_) {}
 
-  struct button_event: event
-  {
-    bool every;
-    bn::vector<bn::string_view, 10> buttons;
-    int events_count;
-    event** events;
-
-    button_event(
-      bn::string_view type_,
-      bool every_,
-      bn::vector<bn::string_view, 10> buttons_,
-      int events_count_,
-      event** events_
-    ): event(type_), every(every_), buttons(buttons_), events_count(events_count_), events(events_) {}
-
-    // Helper constructor for single button
-    button_event(bn::string_view type_, bn::string_view single_button, int events_count_, event** events_):
-      event(type_), every(false), buttons(), events_count(events_count_), events(events_)
+    inline int as_int(neo::variables::registry& variables) const
     {
-      buttons.push_back(single_button);
-    }
-  };
-
-  struct dialog_event: event
-  {
-    bn::vector<bn::string_view, 5> lines;
-    dialog_event(bn::string_view type_, const bn::vector<bn::string_view, 5>& lines_):
-      event(type_), lines(lines_) {}
-  };
-
-  struct set_variable_event: event
-  {
-    bn::string_view key;
-    neo::variables::value* value;
-    set_variable_event(bn::string_view type_, bn::string_view key_, neo::variables::value* value_):
-      event(type_), key(key_), value(value_) {}
-  };
-
-  struct if_expression
-  {
-    bn::string_view type;
-  };
-
-  struct if_expression_variable: if_expression
-  {
-    bn::string_view name;
-
-    if_expression_variable(bn::string_view type_, bn::string_view name_):
-      if_expression(type_), name(name_) {}
-  };
-
-  struct if_expression_value: if_expression
-  {
-    bn::string_view value;
-
-    if_expression_value(bn::string_view type_, bn::string_view value_):
-      if_expression(type_), value(value_) {}
-  };
+      if (slot != -1)
+      {
+        return variables.as_int(slot);
+      }
 
-  struct if_condition
-  {
-    bn::string_view op;
-    neo::types::if_expression* left;
-    neo::types::if_expression* right;
-
-    if_condition(
-      bn::string_view op_,
-      neo::types::if_expression* left_,
-      neo::types::if_expression* right_
-    ): op(op_),
-       left(left_),
-       right(right_) {}
+      return value;
+    }
   };
 
-  struct if_event: event
+  /**
+   * An event list compiled to bytecode by compileEvents (see events.ts),
+   * run by neo::game through a neo::code::reader
+   */
+  struct event_list
   {
-    int conditions_count;
-    if_condition** conditions;
-    int then_events_count;
-    event** then_events;
-    int else_events_count;
-    event** else_events;
-
-    if_event(
-      bn::string_view type_,
-      int conditions_count_,
-      if_condition** conditions_,
-      int then_events_count_,
-      event** then_events_,
-      int else_events_count_,
-      event** else_events_
-    ): event(type_),
-       conditions_count(conditions_count_),
-       conditions(conditions_),
-       then_events_count(then_events_count_),
-       then_events(then_events_),
-       else_events_count(else_events_count_),
-       else_events(else_events_) {}
-  };
+    const unsigned short* code;
+    int size; // In words
 
-  struct disable_actor_event: event
-  {
-    bn::string_view actor;
-    disable_actor_event(bn::string_view type_, bn::string_view actor_):
-      event(type_), actor(actor_) {}
-  };
-
-  struct enable_actor_event: event
-  {
-    bn::string_view actor;
-    enable_actor_event(bn::string_view type_, bn::string_view actor_):
-      event(type_), actor(actor_) {}
+    constexpr bool empty() const
+    {
+      return size <= 0;
+    }
   };
 
-  struct play_music_event: event
+  // Operands of a go-to-scene event, kept until the target scene starts
+  struct scene_event
   {
-    bn::string_view music_name;
-    bn::fixed volume;
-    bool loop;
-    play_music_event(bn::string_view type_, bn::string_view music_name_, bn::fixed volume_, bool loop_):
-      event(type_), music_name(music_name_), volume(volume_), loop(loop_) {}
+    int target_id;
+    int start_x; // -1 keeps the start position of the scene
+    int start_y;
+    neo::types::direction start_direction;
   };
 
-  struct stop_music_event: event
+  // Operands of a wait-for-button or on-button-press event
+  struct button_event
   {
-    stop_music_event(bn::string_view type_):
-      event(type_) {}
+    unsigned keys = 0; // neo::input key mask, 0 never fires
+    neo::types::button_trigger trigger = neo::types::button_trigger::PRESSED;
+    bool every = false; // All keys of the set instead of any of them
+    event_list events = { nullptr, 0 }; // on-button-press handler
   };
 
-  struct play_sound_event: event
+  // Operands of an on-variable-change event
+  struct variable_event
   {
-    bn::string_view sound_name;
-    bn::fixed volume;
-    bn::fixed speed;
-    bn::fixed panning;
-    int priority;
-    play_sound_event(
-      bn::string_view type_,
-      bn::string_view sound_name_,
-      bn::fixed volume_,
-      bn::fixed speed_,
-      bn::fixed panning_,
-      int priority_
-    ):
-      event(type_),
-      sound_name(sound_name_),
-      volume(volume_),
-      speed(speed_),
-      panning(panning_),
-      priority(priority_) {}
+    int slot = -1;
+    int comparison = -1; // neo::code::comparison the new value must pass, -1 for any change
+    int value = 0; // Compared with the new value, in the type of the variable
+    event_list events = { nullptr, 0 };
   };
 
-  struct execute_script_event: event
+  // Laid out at build time, see layoutDialog in events.ts
+  struct dialog_page
   {
-    bn::string_view name;
-    execute_script_event(bn::string_view type_, bn::string_view name_):
-      event(type_), name(name_) {}
+    int lines_count;
+    int width; // Glyphs per line, shorter lines are padded with blanks
+    const unsigned char* glyphs; // Font tiles, line after line
   };
 
-  struct move_camera_to_event: event
+  // Operands of a show-dialog event, pages stay in the event code
+  struct dialog_event
   {
-    event_value* x;
-    event_value* y;
-    event_value* duration;
-    bool allow_diagonal;
-    bn::string_view direction_priority;
-    move_camera_to_event(
-      bn::string_view type_,
-      event_value* x_,
-      event_value* y_,
-      event_value* duration_,
-      bool allow_diagonal_,
-      bn::string_view direction_priority_
-    ):
-      event(type_),
-      x(x_),
-      y(y_),
-      duration(duration_),
-      allow_diagonal(allow_diagonal_),
-      direction_priority(direction_priority_) {}
+    int lines_count; // Of the tallest page, picks the textbox
+    int pages_count;
+    const unsigned short* pages;
+    int speed; // Characters revealed per frame
   };
 
   struct sensor
@@ -307,84 +159,168 @@ namespace neo::types
     int y;
     int width;
     int height;
-    int events_count;
-    event** events;
+    int priority;
+    event_list events; // Run when the player steps in
+    event_list exit_events; // Run when the player steps out
 
-    inline bool is_inside (int tile_x, int tile_y) {
+    inline bool is_inside (int tile_x, int tile_y) const {
       return tile_x >= x && tile_x < (x + width) && tile_y >= y && tile_y < (y + height);
     }
   };
 
-  struct map
+  /**
+   * Map geometry resolved for the current grid size, so per-frame position
+   * math does not read the grid size variable or divide by it.
+   * Rebuilt on scene load and whenever the grid size variable changes.
+   */
+  struct map_metrics
   {
-    int width;
-    int height;
-    event_value* grid_size;
-    const int* collisions;
-    int sensors_count;
-    sensor** sensors;
-
-    inline int to_pixel_x (neo::variables::registry& variables, int tile_x)
+    int grid_size = 1;
+    int grid_shift = 0; // log2(grid_size), or -1 if it is not a power of two
+    int pixel_width = 0;
+    int pixel_height = 0;
+    int half_pixel_width = 0;
+    int half_pixel_height = 0;
+    int camera_min_x = 0;
+    int camera_max_x = 0;
+    int camera_min_y = 0;
+    int camera_max_y = 0;
+
+    void load (int width, int height, int grid_size_)
     {
-      return tile_x * grid_size->as_int(variables);
+      grid_size = grid_size_ > 0 ? grid_size_ : 1;
+      grid_shift = -1;
+
+      for (int shift = 0; shift < 16; ++shift)
+      {
+        if ((1 << shift) == grid_size)
+        {
+          grid_shift = shift;
+          break;
+        }
+      }
+
+      pixel_width = width * grid_size;
+      pixel_height = height * grid_size;
+      half_pixel_width = pixel_width / 2;
+      half_pixel_height = pixel_height / 2;
+
+      camera_max_x = half_pixel_width - SCREEN_WIDTH / 2;
+      camera_min_x = -camera_max_x;
+      camera_max_y = half_pixel_height - SCREEN_HEIGHT / 2;
+      camera_min_y = -camera_max_y;
     }
 
-    inline int to_tile_x (neo::variables::registry& variables, int pixel_x)
+    inline int to_pixel (int tile) const
     {
-      return pixel_x / grid_size->as_int(variables);
+      return grid_shift >= 0 ? tile << grid_shift : tile * grid_size;
     }
 
-    inline int to_pixel_y (neo::variables::registry& variables, int tile_y)
+    inline int to_tile (int pixel) const
     {
-      return tile_y * grid_size->as_int(variables);
+      return grid_shift >= 0 ? pixel >> grid_shift : pixel / grid_size;
     }
 
-    inline int to_tile_y (neo::variables::registry& variables, int pixel_y)
+    inline int clamp_camera_x (int x) const
     {
-      return pixel_y / grid_size->as_int(variables);
+      return bn::min(bn::max(x, camera_min_x), camera_max_x);
     }
 
-    inline int pixel_width (neo::variables::registry& variables) const
+    inline int clamp_camera_y (int y) const
     {
-      return width * grid_size->as_int(variables);
+      return bn::min(bn::max(y, camera_min_y), camera_max_y);
     }
+  };
+
+  /**
+   * Tile layers are packed into 32-bit words in row major order, collisions
+   * use 1 bit per tile and attributes 4 bits per tile (see packTiles)
+   */
+  struct map
+  {
+    static constexpr int COLLISION_SHIFT = 5; // 32 tiles per word
+    static constexpr int ATTRIBUTE_SHIFT = 3; // 8 tiles per word
+    static constexpr unsigned ATTRIBUTE_MASK = 0xF;
+
+    int width;
+    int height;
+    const event_value* grid_size;
+    const unsigned* collisions;
+    const unsigned* attributes;
+    int sensors_count;
+    const sensor* const* sensors;
+    const unsigned short* sensor_rows; // Offsets in sensor_row_items by tile row, height + 1 entries
+    const unsigned short* sensor_row_items; // Sensor indexes covering each row, by priority
 
-    inline int pixel_height (neo::variables::registry& variables) const
+    inline int tile_index (int tile_x, int tile_y) const
     {
-      return height * grid_size->as_int(variables);
+      return tile_y * width + tile_x;
     }
 
-    inline int tile_index (int tile_x, int tile_y)
+    inline bool is_inside (int tile_x, int tile_y) const
     {
-      return tile_y * width + tile_x;
+      return tile_x >= 0 && tile_x < width && tile_y >= 0 && tile_y < height;
     }
 
-    inline bool has_collision (int tile_x, int tile_y)
+    inline bool has_collision (int tile_x, int tile_y) const
     {
-      if (tile_x < 0 || tile_x >= width || tile_y < 0 || tile_y >= height)
+      if (!is_inside(tile_x, tile_y))
       {
         return true;
       }
 
-      return collisions[tile_index(tile_x, tile_y)] == 1;
+      if (collisions == nullptr)
+      {
+        return false;
+      }
+
+      int index = tile_index(tile_x, tile_y);
+      return (collisions[index >> COLLISION_SHIFT] >> (index & 31)) & 1;
+    }
+
+    inline int get_attribute (int tile_x, int tile_y) const
+    {
+      if (attributes == nullptr || !is_inside(tile_x, tile_y))
+      {
+        return 0;
+      }
+
+      int index = tile_index(tile_x, tile_y);
+      return (attributes[index >> ATTRIBUTE_SHIFT] >> ((index & 7) << 2)) & ATTRIBUTE_MASK;
     }
 
-    inline sensor* get_sensor (int tile_x, int tile_y)
+    /**
+     * Fills matches with the sensors covering a tile, highest priority
+     * first, and returns how many were found
+     */
+    inline int get_sensors (int tile_x, int tile_y, const sensor** matches, int max_matches) const
     {
-      if (sensors == nullptr)
+      if (sensor_rows == nullptr || tile_y < 0 || tile_y >= height)
       {
-        return nullptr;
+        return 0;
       }
 
-      for (int i = 0; i < sensors_count; i++)
+      int count = 0;
+
+      for (int i = sensor_rows[tile_y]; i < sensor_rows[tile_y + 1] && count < max_matches; i++)
       {
-        if (sensors[i]->is_inside(tile_x, tile_y))
+        const sensor* s = sensors[sensor_row_items[i]];
+
+        if (tile_x >= s->x && tile_x < (s->x + s->width))
         {
-          return sensors[i];
+          matches[count++] = s;
         }
       }
 
-      return nullptr;
+      return count;
+    }
+
+    inline const sensor* get_sensor (int tile_x, int tile_y) const
+    {
+      const sensor* match = nullptr;
+      get_sensors(tile_x, tile_y, &match, 1);
+
+      return match;
     }
   };
 
@@ -392,26 +328,23 @@ namespace neo::types
   {
     bn::string_view _id;
     bn::string_view name;
-    event_value* x;
-    event_value* y;
-    event_value* z;
+    const event_value* x;
+    const event_value* y;
+    const event_value* z;
     neo::types::direction direction;
     bn::sprite_item sprite;
-    int init_events_count;
-    event** init_events;
-    int interact_events_count;
-    event** interact_events;
-    int update_events_count;
-    event** update_events;
+    event_list init_events;
+    event_list interact_events;
+    event_list update_events;
   };
 
   struct sprite
   {
     bn::string_view _id;
     bn::string_view name;
-    event_value* x;
-    event_value* y;
-    event_value* z;
+    const event_value* x;
+    const event_value* y;
+    const event_value* z;
     bn::sprite_item sprite;
   };
 
@@ -419,8 +352,20 @@ namespace neo::types
   {
     bn::string_view _id;
     bn::string_view name;
-    int events_count;
-    event** events;
+    event_list events;
+
+    inline bool is (bn::string_view name_) const
+    {
+      return _id == name_ || name == name_;
+    }
+  };
+
+  // How the camera tracks the player, see neo::camera::follow
+  struct camera_follow
+  {
+    int deadzone_x; // Pixels the player can move away from the center
+    int deadzone_y;
+    int lerp; // Percent of the distance closed per frame, 100 locks on
   };
 
   struct scene
@@ -429,25 +374,25 @@ namespace neo::types
     bn::string_view _id;
     bn::string_view name;
     bn::regular_bg_item background;
-    int event_count;
-    event** events;
+    event_list events;
     // Player
     bool has_player;
-    event_value* start_x;
-    event_value* start_y;
-    event_value* start_z;
+    const event_value* start_x;
+    const event_value* start_y;
+    const event_value* start_z;
     neo::types::direction start_direction;
     bn::sprite_item player_sprite;
+    neo::types::camera_follow camera_follow;
     // Map data
-    map* map_data;
+    const map* map_data;
     // Actors
     int actors_count;
-    actor** actors;
+    const actor* const* actors;
     // Sprites
     int sprites_count;
-    sprite** sprites;
+    const sprite* const* sprites;
 
-    inline bool is (bn::string_view name_)
+    inline bool is (bn::string_view name_) const
     {
       return _id == name_ || name == name_;
     }
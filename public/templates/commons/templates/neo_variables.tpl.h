@@ -6,91 +6,198 @@
 #include <bn_core.h>
 #include <bn_log.h>
 #include <bn_assert.h>
-#include <bn_unordered_map.h>
+#include <bn_fixed.h>
+#include <bn_string_view.h>
 
 namespace neo::variables
 {
-  struct value
+  /**
+   * Every variable is a single int, its type tells how to read it: bools
+   * are 0 or 1, fixed point is the raw data (4096 = 1.0) and strings are
+   * an index in STRINGS, -1 for none. Must match TYPES in variables.ts.
+   */
+  enum class type
   {
-    bn::string_view name;
-    int int_value;
-    bool bool_value;
-    bn::string_view str_value;
-
-    value(bn::string_view name_, int val_, bool bool_val_, bn::string_view str_val_):
-      name(name_),
-      int_value(val_),
-      bool_value(bool_val_),
-      str_value(str_val_) {}
-
-    inline int as_int () const
+    INT,
+    BOOL,
+    FIXED,
+    STRING
+  };
+
+  inline constexpr int COUNT = {{size (flatVariables variables)}};
+
+  // Variable names by slot, only used for debugging
+  inline constexpr bn::string_view NAMES[] = {
+    {{#each (flatVariables variables)}}
+    "{{cstring this.name}}",
+    {{else}}
+    "",
+    {{/each}}
+  };
+
+  // Types by slot, picked from the default values at build time
+  inline constexpr neo::variables::type TYPES[] = {
+    {{#each (flatVariables variables)}}
+    neo::variables::type::{{variableType this.defaultValue}},
+    {{else}}
+    neo::variables::type::INT,
+    {{/each}}
+  };
+
+  // Default values by slot, stay in ROM and are copied into the registry
+  inline constexpr int DEFAULTS[] = {
+    {{#each (flatVariables variables)}}
+    {{variableDefault this.defaultValue}},
+    {{else}}
+    0,
+    {{/each}}
+  };
+
+  // Every value a string variable can hold, interned at build time so
+  // string variables compare as ints
+  inline constexpr bn::string_view STRINGS[] = {
+    {{#each (stringTable)}}
+    "{{cstring this}}",
+    {{else}}
+    "",
+    {{/each}}
+  };
+
+  inline constexpr int STRINGS_COUNT = {{size (stringTable)}};
+
+  // Converts a variable int between types
+  constexpr int convert(int value, neo::variables::type from, neo::variables::type to)
+  {
+    if (from == to)
     {
-      return int_value;
+      return value;
     }
 
-    inline bool as_bool () const
+    if (from == type::STRING)
     {
-      return bool_value;
+      return to == type::BOOL && value >= 0 && value < STRINGS_COUNT && !STRINGS[value].empty();
     }
 
-    inline bn::string_view as_string () const
+    switch (to)
     {
-      return str_value;
+      case type::INT:
+        return from == type::FIXED ? value / 4096 : value;
+      case type::BOOL:
+        return value != 0;
+      case type::FIXED:
+        return value * 4096;
+      default:
+        return -1;
     }
-  };
+  }
 
+  /**
+   * The only mutable game data, everything generated from the project is
+   * const and placed in ROM
+   */
   struct registry
   {
-    bn::unordered_map<bn::string_view, neo::variables::value*, {{or (powerOfTwo (valuesCount variables)) 1}}> all;
+    int values[COUNT > 0 ? COUNT : 1];
 
-    registry(): all()
+    registry()
     {
-      {{#each variables}}
-      {{#each this.values}}
-      neo::variables::value* value_{{@../index}}_{{slug this.name}}_{{@index}} = new neo::variables::value(
-        "{{this.name}}",
-        {{int this.defaultValue}},
-        {{bool this.defaultValue}},
-        "{{this.defaultValue}}"
-      );
-      all.insert_or_assign(
-        "{{this.name}}",
-        value_{{@../index}}_{{slug this.name}}_{{@index}}
-      );
-      {{/each}}
-      {{/each}}
+      for (int i = 0; i < COUNT; ++i)
+      {
+        values[i] = DEFAULTS[i];
+      }
     }
 
-    inline bool has(bn::string_view key)
+    inline int slot(bn::string_view key) const
     {
       if (key.empty()) {
-        return false;
+        return -1;
       }
 
-      return all.find(key) != all.end();
+      for (int i = 0; i < COUNT; ++i)
+      {
+        if (NAMES[i] == key)
+        {
+          return i;
+        }
+      }
+
+      return -1;
     }
 
-    inline neo::variables::value& get(bn::string_view key)
+    inline bool has(bn::string_view key) const
     {
-      BN_ASSERT(!key.empty(), "Empty variable key requested");
+      return slot(key) != -1;
+    }
 
-      auto it = all.find(key);
-      BN_ASSERT(it != all.end(), "Variable not found: ", key);
-      return *(it->second);
+    inline neo::variables::type type(int slot_) const
+    {
+      BN_ASSERT(slot_ >= 0 && slot_ < COUNT, "Invalid variable slot: ", slot_);
+      return TYPES[slot_];
     }
 
-    inline void set(bn::string_view key, neo::variables::value* value)
+    // The value of a slot, as stored
+    inline int get(int slot_) const
     {
-      if (key.empty()) {
-        BN_LOG("Empty variable key set attempted");
-        return;
+      BN_ASSERT(slot_ >= 0 && slot_ < COUNT, "Invalid variable slot: ", slot_);
+      return values[slot_];
+    }
+
+    // The value of a slot, read as another type
+    inline int get(int slot_, neo::variables::type type_) const
+    {
+      return convert(get(slot_), TYPES[slot_], type_);
+    }
+
+    inline int as_int(int slot_) const
+    {
+      return get(slot_, type::INT);
+    }
+
+    inline bool as_bool(int slot_) const
+    {
+      return get(slot_, type::BOOL);
+    }
+
+    inline bn::fixed as_fixed(int slot_) const
+    {
+      return bn::fixed::from_data(get(slot_, type::FIXED));
+    }
+
+    inline bn::string_view as_string(int slot_) const
+    {
+      int index = get(slot_, type::STRING);
+      return index >= 0 && index < STRINGS_COUNT ? STRINGS[index] : bn::string_view();
+    }
+
+    // Stores a value already in the type of the slot, returns whether it
+    // changed so on-variable-change handlers only run when it did
+    inline bool set(int slot_, int value)
+    {
+      if (slot_ < 0 || slot_ >= COUNT) {
+        BN_LOG("Invalid variable slot set attempted: ", slot_);
+        return false;
       }
 
-      auto it = all.find(key);
-      BN_ASSERT(it != all.end(), "Variable not found: ", key);
+      bool changed = values[slot_] != value;
+      values[slot_] = value;
+
+      switch (TYPES[slot_])
+      {
+        case type::BOOL:
+          BN_LOG("Setting variable:", NAMES[slot_], ", to value:", value ? "true" : "false");
+          break;
+        case type::FIXED:
+          BN_LOG("Setting variable:", NAMES[slot_], ", to value:", as_fixed(slot_));
+          break;
+        case type::STRING:
+          BN_LOG("Setting variable:", NAMES[slot_], ", to value:", as_string(slot_));
+          break;
+        default:
+          BN_LOG("Setting variable:", NAMES[slot_], ", to value:", value);
+          break;
+      }
 
-      BN_LOG("Setting variable:", key, ", to value:", value->as_string());
-      it->second = value;
+      return changed;
     }
   };
 }
@@ -0,0 +1,719 @@
+// Event compiler: serializes event lists into the bytecode interpreted by
+// neo::game (see include/code.h). Each event is an opcode word followed by
+// its operands, all 16-bit words. Jumps are relative and there are no
+// pointers, so a list can be moved or patched in a ROM without rebuilding
+// the C++ sources.
+//
+// Operands:
+// - value: a variable slot, or IMMEDIATE followed by an int already in
+//   the representation the event reads (see variables.ts)
+// - int, fixed: 32 bits, low word first, fixed point is 4096 = 1.0
+// - string, bytes: the length, then the bytes two per word, first one in
+//   the low byte so the little-endian runtime reads them in place
+// - jump: the offset in words from the end of the operand, bodies
+//   (on-button-press events) are a jump over them followed by their code
+// - condition: a tree in prefix order. Comparisons are their operator
+//   word, the type both sides are read as in its high byte, then both
+//   values. AND and OR nodes are their operator word and a jump over
+//   their children, so the runtime can stop at the first child that
+//   decides them. NOT never reaches the runtime: it flips comparisons
+//   and swaps AND and OR at build time
+
+import {
+  TYPES,
+  type VariableType,
+  constantValue,
+  toRaw,
+  valueType,
+  variableSlot,
+  variableType,
+} from './variables';
+
+// Must match neo::types::event_type
+export const OPCODES = {
+  unknown: 0,
+  wait: 1,
+  'fade-in': 2,
+  'fade-out': 3,
+  'wait-for-button': 4,
+  'on-button-press': 5,
+  'go-to-scene': 6,
+  'show-dialog': 7,
+  'set-variable': 8,
+  if: 9,
+  'disable-actor': 10,
+  'enable-actor': 11,
+  'play-music': 12,
+  'stop-music': 13,
+  'play-sound': 14,
+  'execute-script': 15,
+  'move-camera-to': 16,
+  jump: 17,
+  'add-variable': 18,
+  'subtract-variable': 19,
+  'multiply-variable': 20,
+  'clamp-variable': 21,
+  'random-variable': 22,
+  'on-variable-change': 23,
+};
+
+export const IMMEDIATE = 0xffff;
+
+// Must match neo::types::button_trigger and neo::types::easing
+const TRIGGERS = ['pressed', 'held', 'released'];
+const EASINGS = ['linear', 'ease-in', 'ease-out', 'ease-in-out', 'smoothstep'];
+const DIRECTIONS = ['left', 'right', 'up', 'down'];
+
+// Must match neo::code::comparison
+const COMPARISONS: Record<string, number> = {
+  '==': 0, eq: 0,
+  '!=': 1, neq: 1,
+  '<': 2, lt: 2,
+  '<=': 3, lte: 3,
+  '>': 4, gt: 4,
+  '>=': 5, gte: 5,
+};
+
+const AND = 6;
+const OR = 7;
+
+const LOGICAL: Record<string, number> = {
+  '&&': AND, and: AND,
+  '||': OR, or: OR,
+};
+
+// The comparison that holds when one does not, by comparison
+const NEGATED = [1, 0, 5, 4, 3, 2];
+
+// on-variable-change without a filter on the new value
+const ANY_CHANGE = 0xff;
+
+// Editor button names, in the bit order of the GBA keypad register
+const BUTTON_KEYS = [
+  'A', 'B', 'Select', 'Start', 'Right', 'Left', 'Up', 'Down', 'R', 'L',
+];
+
+// Folds a button set into the key mask the runtime tests in one AND
+export const buttonKeys = (buttons: string[]) =>
+  buttons.reduce((m, button) => {
+    const bit = BUTTON_KEYS.indexOf(button);
+
+    return bit >= 0 ? m | (1 << bit) : m;
+  }, 0);
+
+// Project data the compiler resolves names against
+export interface EventsContext {
+  variables?: any[];
+  scenes?: any[];
+  scripts?: any[];
+}
+
+// Dialog box text area and font, see include/dialog.h and text_layer.h.
+// Layout works in pixels, gbs_mono glyphs are all 8 pixels wide
+const DIALOG_WIDTH = 216;
+const DIALOG_PAGE_LINES = 3;
+const GLYPH_WIDTH = 8;
+const FIRST_GLYPH = 32;
+const LAST_GLYPH = 126;
+
+const measure = (text: string) => text.length * GLYPH_WIDTH;
+
+// Font tile of a character, unknown ones show as '?'
+const glyphIndex = (char: string) => {
+  const code = char.charCodeAt(0);
+
+  return (code >= FIRST_GLYPH && code <= LAST_GLYPH ? code : 63) -
+    FIRST_GLYPH;
+};
+
+// Word wraps dialog text to the box width and splits it into pages,
+// each page a grid of font tiles the runtime copies as is
+export const layoutDialog = (
+  text: string,
+  maxWidth = DIALOG_WIDTH,
+  pageLines = DIALOG_PAGE_LINES,
+) => {
+  const lines: string[] = [];
+
+  (text || '').split(/\r?\n/).forEach(paragraph => {
+    let line = '';
+
+    paragraph.split(' ').forEach(chunk => {
+      let word = chunk;
+
+      // Words wider than the box are cut where they overflow
+      while (measure(word) > maxWidth) {
+        const head = word.slice(0, Math.floor(maxWidth / GLYPH_WIDTH));
+
+        if (line) {
+          lines.push(line);
+          line = '';
+        }
+
+        lines.push(head);
+        word = word.slice(head.length);
+      }
+
+      const candidate = line ? line + ' ' + word : word;
+
+      if (measure(candidate) <= maxWidth) {
+        line = candidate;
+      } else {
+        lines.push(line);
+        line = word;
+      }
+    });
+
+    lines.push(line);
+  });
+
+  const pages = [];
+
+  for (let i = 0; i < lines.length; i += pageLines) {
+    const page = lines.slice(i, i + pageLines);
+    const width = Math.max(1, ...page.map(line => line.length));
+    const glyphs = page.flatMap(line =>
+      [...line.padEnd(width)].map(char => glyphIndex(char)));
+
+    pages.push({ lines: page.length, width, glyphs });
+  }
+
+  return {
+    linesCount: Math.max(...pages.map(page => page.lines)),
+    pages,
+  };
+};
+
+const isRawValue = (value: any) =>
+  ['string', 'number', 'boolean'].includes(typeof value);
+
+const toInt = (value: any) => parseInt(value, 10) || 0;
+
+const toBool = (value: any) =>
+  typeof value === 'string' ? value === 'true' : !!value;
+
+const orDefault = (value: any, fallback: any) =>
+  typeof value !== 'undefined' && value !== null && value !== ''
+    ? value : fallback;
+
+const itemIndex = (items: any[] | undefined, id: string) =>
+  (items || []).findIndex(i => i.id === id || i.name === id);
+
+const slotOf = (context: EventsContext, value: any) =>
+  value?.type === 'variable' ? variableSlot(context.variables, value.name) : -1;
+
+class Writer {
+  words: number[] = [];
+
+  word(value: number) {
+    this.words.push(value & 0xffff);
+  }
+
+  int(value: number) {
+    this.word(value);
+    this.word(value >> 16);
+  }
+
+  fixed(value: number) {
+    this.int(Math.round((Number(value) || 0) * 4096));
+  }
+
+  bytes(bytes: number[]) {
+    this.word(bytes.length);
+
+    for (let i = 0; i < bytes.length; i += 2) {
+      this.word(bytes[i] | ((bytes[i + 1] || 0) << 8));
+    }
+  }
+
+  string(value: any) {
+    this.bytes([...Buffer.from(String(value ?? ''), 'utf8')]);
+  }
+
+  // Reserves a jump offset, set by land once its target is known
+  jump() {
+    this.word(0);
+
+    return this.words.length - 1;
+  }
+
+  land(at: number) {
+    this.words[at] = this.words.length - at - 1;
+  }
+}
+
+// A variable, or a constant converted to type
+const compileValue = (
+  out: Writer,
+  context: EventsContext,
+  value: any,
+  type: VariableType = 'int',
+) => {
+  const slot = slotOf(context, value);
+
+  if (slot >= 0) {
+    out.word(slot);
+    return;
+  }
+
+  out.word(IMMEDIATE);
+  out.int(toRaw(context, constantValue(value), type));
+};
+
+// One side of a comparison: a variable, or a constant (unknown variables
+// read as an empty string, like they always did)
+const operand = (context: EventsContext, value: any) => {
+  const slot = slotOf(context, value);
+
+  return slot >= 0
+    ? { slot, type: variableType(context.variables, slot) }
+    : { value: isRawValue(value) ? value : '' };
+};
+
+// Variables of different types compare as the widest number type,
+// strings only against strings
+const comparisonType = (types: VariableType[]): VariableType => {
+  if (types.length === 1 || types[0] === types[1]) {
+    return types[0];
+  }
+
+  if (types.includes('fixed')) {
+    return 'fixed';
+  }
+
+  return types.find(type => type !== 'string' && type !== 'bool') ||
+    types.find(type => type !== 'string') || 'int';
+};
+
+const compare = (comparison: number, left: any, right: any) => {
+  switch (comparison) {
+    case 0: return left === right;
+    case 1: return left !== right;
+    case 2: return left < right;
+    case 3: return left <= right;
+    case 4: return left > right;
+    default: return left >= right;
+  }
+};
+
+// A compiled condition: its result when known at build time, a
+// comparison's code, or an AND or OR of other conditions
+type ConditionNode = boolean | { words: number[] } |
+  { op: number, children: ConditionNode[] };
+
+const isCondition = (value: any) => value?.type === 'condition';
+
+// Compiles a comparison, or returns its result when both sides are
+// constants, the same variable, or it can never hold
+const compileComparison = (
+  context: EventsContext,
+  condition: any,
+  negate: boolean,
+): ConditionNode => {
+  const comparison = COMPARISONS[condition.operator];
+  const left = operand(context, condition.left);
+  const right = operand(context, condition.right);
+
+  if (comparison === undefined) {
+    return negate;
+  }
+
+  if (left.slot === undefined && right.slot === undefined) {
+    const numbers = valueType(left.value) !== 'string' &&
+      valueType(right.value) !== 'string';
+
+    return negate !== (numbers
+      ? compare(comparison, toRaw(context, left.value, 'fixed'),
+        toRaw(context, right.value, 'fixed'))
+      : comparison <= 1 &&
+        compare(comparison, String(left.value), String(right.value)));
+  }
+
+  if (left.slot === right.slot) {
+    return negate !== compare(comparison, 0, 0);
+  }
+
+  // Constants can't make a variable a string or stop it from being one,
+  // but fractional ones widen numbers so hp < 1.5 isn't hp < 1
+  const variablesType = comparisonType([left, right]
+    .filter(side => side.slot !== undefined)
+    .map(side => side.type));
+  const type = variablesType !== 'string' && [left, right]
+    .some(side => side.slot === undefined && valueType(side.value) === 'fixed')
+    ? 'fixed' : variablesType;
+
+  // Strings are table indexes, only equality means something
+  if (type === 'string' && comparison > 1) {
+    return negate;
+  }
+
+  const out = new Writer();
+  out.word((negate ? NEGATED[comparison] : comparison) |
+    (TYPES.indexOf(type) << 8));
+  compileValue(out, context, condition.left, type);
+  compileValue(out, context, condition.right, type);
+
+  return { words: out.words };
+};
+
+// Drops the children that can't change the result and merges nested
+// nodes of the same operator, the result is known when a constant
+// child decides it or no child is left
+const compileLogical = (op: number, parts: ConditionNode[]): ConditionNode => {
+  const children: ConditionNode[] = [];
+
+  for (const part of parts) {
+    if (typeof part === 'boolean') {
+      // false decides an AND, true an OR
+      if (part === (op === OR)) {
+        return part;
+      }
+
+      continue;
+    }
+
+    children.push(...('op' in part && part.op === op ? part.children : [part]));
+  }
+
+  if (!children.length) {
+    return op === AND;
+  }
+
+  return children.length === 1 ? children[0] : { op, children };
+};
+
+const compileCondition = (
+  context: EventsContext,
+  condition: any,
+  negate = false,
+): ConditionNode => {
+  const negated = negate !== !!condition?.negate;
+
+  // A bare value holds when it isn't false, 0 or empty
+  if (!isCondition(condition)) {
+    return compileComparison(context, {
+      left: condition,
+      operator: '!=',
+      right: false,
+    }, negated);
+  }
+
+  const logical = LOGICAL[condition.operator];
+
+  if (logical === undefined) {
+    return compileComparison(context, condition, negated);
+  }
+
+  // !(a && b) is !a || !b, and !(a || b) is !a && !b
+  return compileLogical(negated ? AND + OR - logical : logical, [
+    compileCondition(context, condition.left, negated),
+    compileCondition(context, condition.right, negated),
+  ]);
+};
+
+const writeCondition = (out: Writer, node: ConditionNode) => {
+  if (typeof node === 'boolean') {
+    return;
+  }
+
+  if ('words' in node) {
+    out.words.push(...node.words);
+    return;
+  }
+
+  out.word(node.op);
+  const end = out.jump();
+  node.children.forEach(child => writeCondition(out, child));
+  out.land(end);
+};
+
+const compileIf = (out: Writer, context: EventsContext, event: any) => {
+  // Conditions of the list must all hold
+  const condition = compileLogical(AND, [].concat(event.conditions || [])
+    .map((c: any) => compileCondition(context, c)));
+
+  // Constant conditions pick their branch now
+  if (typeof condition === 'boolean') {
+    compileList(out, context, condition ? event.then : event.else);
+    return;
+  }
+
+  const elseEvents = [].concat(event.else || []);
+
+  out.word(OPCODES.if);
+  writeCondition(out, condition);
+
+  // Jump to the else branch when the condition fails, and over it at
+  // the end of the then branch
+  const toElse = out.jump();
+
+  compileList(out, context, event.then);
+
+  if (elseEvents.length) {
+    out.word(OPCODES.jump);
+    const toEnd = out.jump();
+
+    out.land(toElse);
+    compileList(out, context, elseEvents);
+    out.land(toEnd);
+  } else {
+    out.land(toElse);
+  }
+};
+
+const isConstant = (context: EventsContext, value: any) =>
+  slotOf(context, value) < 0;
+
+// set-variable and update-variable, folded into the fewest events:
+// inc and dec add a constant, neutral operations are dropped
+const compileVariable = (out: Writer, context: EventsContext, event: any) => {
+  const slot = variableSlot(context.variables, event.name);
+  const type = variableType(context.variables, slot);
+  const raw = (value: any) => toRaw(context, orDefault(value, 0), type);
+
+  const emit = (name: string, ...operands: any[]) => {
+    out.word((OPCODES as Record<string, number>)[name]);
+    out.word(slot);
+    operands.forEach(value => compileValue(out, context, value, type));
+  };
+
+  if (slot < 0) {
+    return;
+  }
+
+  if (event.type === 'set-variable') {
+    if (slotOf(context, event.value) !== slot) {
+      emit('set-variable', event.value);
+    }
+    return;
+  }
+
+  // Arithmetic on strings means nothing
+  if (type === 'string') {
+    return;
+  }
+
+  switch (event.operation) {
+    case 'inc':
+    case 'dec':
+      emit('add-variable', event.operation === 'dec' ? -1 : 1);
+      break;
+
+    case 'add':
+    case 'sub':
+      if (!isConstant(context, event.value)) {
+        emit(event.operation === 'add' ? 'add-variable' : 'subtract-variable',
+          event.value);
+      } else if (raw(event.value) !== 0) {
+        emit('add-variable',
+          (event.operation === 'sub' ? -1 : 1) * Number(event.value));
+      }
+      break;
+
+    case 'mul':
+      if (!isConstant(context, event.value)) {
+        emit('multiply-variable', event.value);
+      } else if (raw(event.value) === 0) {
+        emit('set-variable', 0);
+      } else if (raw(event.value) !== raw(1)) {
+        emit('multiply-variable', event.value);
+      }
+      break;
+
+    case 'clamp':
+      emit('clamp-variable', event.min, event.max);
+      break;
+
+    case 'random':
+      if (isConstant(context, event.min) && isConstant(context, event.max) &&
+        raw(event.min) === raw(event.max)) {
+        emit('set-variable', event.min);
+      } else {
+        emit('random-variable', event.min, event.max);
+      }
+      break;
+
+    default:
+      break;
+  }
+};
+
+const compileButtons = (out: Writer, event: any) => {
+  const trigger = TRIGGERS.indexOf(event.trigger);
+
+  out.word(buttonKeys([].concat(event.buttons || [])));
+  out.word(Math.max(0, trigger) | (toBool(event.every) ? 0x100 : 0));
+};
+
+// The handler code follows, skipped when the event runs and registered
+// for the runtime to start whenever the variable changes
+const compileWatch = (out: Writer, context: EventsContext, event: any) => {
+  const slot = variableSlot(context.variables, event.name);
+  const type = variableType(context.variables, slot);
+  const comparison = COMPARISONS[event.operator];
+  const filtered = comparison !== undefined &&
+    typeof event.value !== 'undefined';
+
+  // Unknown variables never change, string variables have no order
+  if (slot < 0 || (filtered && type === 'string' && comparison > 1)) {
+    return;
+  }
+
+  out.word(OPCODES['on-variable-change']);
+  out.word(slot);
+
+  if (filtered) {
+    out.word(comparison);
+    out.int(toRaw(context, event.value, type));
+  } else {
+    out.word(ANY_CHANGE);
+  }
+
+  const end = out.jump();
+
+  compileList(out, context, event.events);
+  out.land(end);
+};
+
+const compileEvent = (out: Writer, context: EventsContext, event: any) => {
+  const opcode = (OPCODES as Record<string, number>)[event.type];
+
+  if (event.type === 'if') {
+    compileIf(out, context, event);
+    return;
+  }
+
+  if (event.type === 'set-variable' || event.type === 'update-variable') {
+    compileVariable(out, context, event);
+    return;
+  }
+
+  if (event.type === 'on-variable-change') {
+    compileWatch(out, context, event);
+    return;
+  }
+
+  // Unknown scripts are dropped, the runtime would run its default one
+  if (event.type === 'execute-script' &&
+    itemIndex(context.scripts, event.script) < 0) {
+    return;
+  }
+
+  if (opcode === undefined || opcode >= OPCODES.jump) {
+    out.word(OPCODES.unknown);
+    return;
+  }
+
+  out.word(opcode);
+
+  switch (event.type) {
+    case 'wait':
+    case 'fade-in':
+    case 'fade-out':
+      compileValue(out, context, event.duration);
+      break;
+
+    case 'wait-for-button':
+      compileButtons(out, event);
+      break;
+
+    case 'on-button-press': {
+      // The handler code follows, skipped unless the buttons fired
+      compileButtons(out, event);
+      const end = out.jump();
+
+      compileList(out, context, event.events);
+      out.land(end);
+      break;
+    }
+
+    case 'go-to-scene': {
+      const target = itemIndex(context.scenes, event.target);
+
+      out.word(target >= 0 ? target : (context.scenes || []).length);
+      compileValue(out, context, orDefault(event.start?.x, -1));
+      compileValue(out, context, orDefault(event.start?.y, -1));
+      out.word(Math.max(0,
+        DIRECTIONS.indexOf(orDefault(event.start?.direction, 'down'))));
+      break;
+    }
+
+    case 'show-dialog': {
+      const layout = layoutDialog(event.text);
+
+      out.word(layout.linesCount);
+      out.word(toInt(orDefault(event.speed, 4)));
+      out.word(layout.pages.length);
+
+      layout.pages.forEach(page => {
+        out.word(page.lines);
+        out.word(page.width);
+        out.bytes(page.glyphs);
+      });
+      break;
+    }
+
+    case 'disable-actor':
+    case 'enable-actor':
+      out.string(event.actor);
+      break;
+
+    case 'play-music':
+      out.string(event.name);
+      out.fixed(orDefault(event.volume, 100));
+      out.word(toBool(event.loop) ? 1 : 0);
+      break;
+
+    case 'play-sound':
+      out.string(event.name);
+      out.fixed(orDefault(event.volume, 100));
+      out.fixed(orDefault(event.speed, 1));
+      out.fixed(orDefault(event.panning, 0));
+      out.word(toInt(event.priority));
+      break;
+
+    case 'execute-script':
+      out.word(itemIndex(context.scripts, event.script));
+      break;
+
+    case 'move-camera-to':
+      compileValue(out, context, orDefault(event.x, 0));
+      compileValue(out, context, orDefault(event.y, 0));
+      compileValue(out, context, orDefault(event.duration, 200));
+      out.word((toBool(orDefault(event.allowDiagonal, true)) ? 1 : 0) |
+        (event.directionPriority === 'vertical' ? 2 : 0));
+      out.word(Math.max(0, EASINGS.indexOf(event.easing)));
+      break;
+
+    default:
+      break;
+  }
+};
+
+// Disabled events are left out of the code
+const compileList = (out: Writer, context: EventsContext, events: any[]) => {
+  [].concat(events || [])
+    .filter((event: any) => event && event.enabled !== false)
+    .forEach(event => compileEvent(out, context, event));
+};
+
+export const compileEvents = (events: any[], context: EventsContext) => {
+  const out = new Writer();
+
+  compileList(out, context, events);
+
+  return out.words;
+};
+
+// Hex words, a few per line to keep the generated headers readable
+export const formatCode = (words: number[], perLine = 12) => {
+  const lines: string[] = [];
+
+  for (let i = 0; i < words.length; i += perLine) {
+    lines.push(words.slice(i, i + perLine)
+      .map(w => '0x' + w.toString(16).padStart(4, '0'))
+      .join(', '));
+  }
+
+  return lines.join(',\n  ');
+};
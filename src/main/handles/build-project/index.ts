@@ -18,6 +18,7 @@ import {
   sendSuccessLog,
 } from './utils';
 import { buildTemplates, compileTemplate } from './templates';
+import { reportSizes } from './sizes';
 import { serialize } from '../../serialize';
 import { sanitize } from '../../sanitize';
 import Storage from '../../storage';
@@ -146,6 +147,18 @@ async function buildMakefile (
           path.join(getResourcesDir(), './public/templates/commons/audio'),
         ),
       ],
+      benchScript: path.relative(
+        getBuildDir(build),
+        path.join(getResourcesDir(), './public/templates/commons/bench/bench.py'),
+      ),
+      replayScript: path.relative(
+        getBuildDir(build),
+        path.join(getResourcesDir(), './public/templates/commons/bench/replay.py'),
+      ),
+      benchInput: path.relative(
+        getBuildDir(build),
+        path.join(path.dirname(build.projectPath), 'bench', 'input.txt'),
+      ),
       romTitle: build.data?.project?.romName || 'My Game',
       romCode: build.data?.project?.romCode || 'ABCD',
     }
@@ -191,6 +204,8 @@ async function buildProject (
     build,
   });
 
+  await reportSizes(event, build, target);
+
   const finalGamePath = path.join(
     path.dirname(build.projectPath),
     'out',
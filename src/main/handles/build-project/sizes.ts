@@ -0,0 +1,66 @@
+import path from 'node:path';
+
+import type { IpcMainInvokeEvent } from 'electron';
+import fse from 'fs-extra';
+
+import type { Build } from '../../../types';
+import { getBuildDir, runCommand, sendLog, sendSuccessLog } from './utils';
+
+// Sections worth watching: .rodata stays in ROM, .data is copied to RAM at
+// boot and .bss is RAM initialized at runtime
+const SECTIONS = ['.rodata', '.data', '.bss'];
+const REPORT_FILE = 'sizes.json';
+
+const getSizeCommand = () => process.env.DEVKITARM
+  ? path.join(process.env.DEVKITARM, 'bin', 'arm-none-eabi-size')
+  : 'arm-none-eabi-size';
+
+const parseSizes = (output: string) => {
+  const sizes: Record<string, number> = {};
+
+  output.split(/\r?\n/).forEach(line => {
+    const [name, size] = line.trim().split(/\s+/);
+
+    if (SECTIONS.includes(name)) {
+      sizes[name] = (sizes[name] || 0) + (parseInt(size, 10) || 0);
+    }
+  });
+
+  return sizes;
+};
+
+export const reportSizes = async (
+  event: IpcMainInvokeEvent,
+  build: Build,
+  target: string,
+): Promise<void> => {
+  const buildDir = getBuildDir(build);
+  const reportPath = path.join(buildDir, REPORT_FILE);
+
+  try {
+    const output = await runCommand(getSizeCommand(), [
+      '-A',
+      path.join(buildDir, target + '.elf'),
+    ], { cwd: buildDir, event, build, log: false });
+
+    const sizes = parseSizes(output);
+    const previous: Record<string, number> =
+      await fse.pathExists(reportPath)
+        ? await fse.readJson(reportPath)
+        : {};
+
+    SECTIONS.forEach(section => {
+      const size = sizes[section] || 0;
+      const delta = size - (previous[section] ?? size);
+
+      sendLog(event, build.id, `${section}: ${size} bytes` +
+        (delta !== 0 ? ` (${delta > 0 ? '+' : ''}${delta})` : ''));
+    });
+
+    await fse.outputJson(reportPath, sizes);
+    sendSuccessLog(event, build.id, 'Section sizes reported');
+  } catch (e) {
+    sendLog(event, build.id, 'Could not report section sizes: ' +
+      (e as Error).message);
+  }
+};
@@ -5,9 +5,119 @@ import Handlebars from 'handlebars';
 import fse from 'fs-extra';
 
 import type { Build } from '../../../types';
+import { compileEvents, formatCode } from './events';
+import { stringTable, toRaw, valueType } from './variables';
 import { getBuildDir, sendLog, sendSuccessLog, toSlug } from './utils';
 import { getResourcesDir } from '../../utils';
 
+// FNV-1a over the UTF-8 bytes, must match neo::scenes::hash
+const hashName = (str: string, seed: number) => {
+  let h = (2166136261 ^ seed) >>> 0;
+
+  for (const byte of Buffer.from(str, 'utf8')) {
+    h = Math.imul(h ^ byte, 16777619) >>> 0;
+  }
+
+  return h;
+};
+
+// Finds a seed for which every name and id of the items lands in its own
+// slot of a power-of-two table, slots hold the item index or -1
+export const perfectHash = (items: { id?: string; name?: string }[]) => {
+  const keys = new Map<string, number>();
+
+  items.forEach((item, index) => {
+    [item.name, item.id].forEach(key => {
+      if (key && !keys.has(key)) {
+        keys.set(key, index);
+      }
+    });
+  });
+
+  let size = 1;
+
+  while (size < keys.size * 2) {
+    size *= 2;
+  }
+
+  for (;;) {
+    for (let seed = 0; seed < 4096; seed++) {
+      const slots = new Array(size).fill(-1);
+      let collides = false;
+
+      for (const [key, index] of keys) {
+        const slot = hashName(key, seed) & (size - 1);
+
+        if (slots[slot] !== -1) {
+          collides = true;
+          break;
+        }
+
+        slots[slot] = index;
+      }
+
+      if (!collides) {
+        return { seed, size, slots };
+      }
+    }
+
+    size *= 2;
+  }
+};
+
+// Packs a grid of tile values into 32-bit words, `bits` per tile in row
+// major order, must match the lookups in neo::types::map
+export const packTiles = (
+  rows: any[],
+  width: number,
+  height: number,
+  bits: number,
+) => {
+  const perWord = 32 / bits;
+  const mask = (1 << bits) - 1;
+  const words = new Array(Math.ceil((width * height) / perWord)).fill(0);
+
+  for (let y = 0; y < height; y++) {
+    const row = typeof rows[y] === 'string' ? rows[y].split(',') : rows[y];
+
+    for (let x = 0; x < width; x++) {
+      const value = Math.min(parseInt(row?.[x], 10) || 0, mask);
+      const index = y * width + x;
+
+      words[Math.floor(index / perWord)] |= value << ((index % perWord) * bits);
+    }
+  }
+
+  return words.map(w => '0x' + (w >>> 0).toString(16).padStart(8, '0'));
+};
+
+// Groups sensors by the map rows they cover, highest priority first, so
+// the game only tests the few sensors of the row the player stands on.
+// Row y spans items[offsets[y]] to items[offsets[y + 1]]
+export const sensorRows = (sensors: any[], height: number) => {
+  const order = sensors
+    .map((sensor, index) => ({ sensor, index }))
+    .sort((a, b) => (Number(b.sensor.priority) || 0) -
+      (Number(a.sensor.priority) || 0) || a.index - b.index);
+  const offsets = [0];
+  const items: number[] = [];
+
+  for (let y = 0; y < height; y++) {
+    order.forEach(({ sensor, index }) => {
+      const top = Number(sensor.y) || 0;
+      const bottom = top + (Number(sensor.height) || 1);
+
+      if (y >= top && y < bottom) {
+        items.push(index);
+      }
+    });
+
+    offsets.push(items.length);
+  }
+
+  return { offsets, items };
+};
+
 export const setupHandlebars = async () => {
   // Add helpers
   Handlebars.registerHelper('ensureArray', value => [].concat(value || []));
@@ -15,6 +125,14 @@ export const setupHandlebars = async () => {
     Array.isArray(arr) && arr.length > 0);
   Handlebars.registerHelper('slug', (str: string) => toSlug(str));
   Handlebars.registerHelper('int', (v: any) => parseInt(v, 10) || 0);
+  // Project text as the inside of a C++ string literal
+  Handlebars.registerHelper('cstring', (v: any) =>
+    String(v ?? '')
+      .replace(/\\/g, '\\\\')
+      .replace(/"/g, '\\"')
+      .replace(/\n/g, '\\n')
+      .replace(/\r/g, '\\r')
+      .replace(/\t/g, '\\t'));
   Handlebars.registerHelper('bool', (v: any) =>
     typeof v === 'string' ? v === 'true' : !!v);
   Handlebars.registerHelper('eq', (a, b) => a === b);
@@ -28,6 +146,7 @@ export const setupHandlebars = async () => {
   Handlebars.registerHelper('isset', v => !!v);
   Handlebars.registerHelper('multiply', (a, b) => a * b);
   Handlebars.registerHelper('or', (a, b) => a || b);
+  Handlebars.registerHelper('and', (a, b) => a && b);
   Handlebars.registerHelper('entries', obj => Object.entries(obj));
   Handlebars.registerHelper('concat', (...args) => args.slice(0, -1).join(''));
   Handlebars.registerHelper('uppercase', (str: string) => str.toUpperCase());
@@ -47,6 +166,33 @@ export const setupHandlebars = async () => {
     return variables.flatMap(v => v.values)
       .find(v => v.id === id || v.name === id);
   });
+  Handlebars.registerHelper('flatVariables', (variables: any[]) =>
+    variables.flatMap(v => v.values));
+  Handlebars.registerHelper('variableType', (value: any) =>
+    valueType(value).toUpperCase());
+  Handlebars.registerHelper('variableDefault', (value: any, options: any) =>
+    toRaw(options.data.root, value, valueType(value)));
+  Handlebars.registerHelper('stringTable', (options: any) =>
+    stringTable(options.data.root));
+  Handlebars.registerHelper('variableIndex', (variables: any[], id: string) =>
+    variables.flatMap(v => v.values)
+      .findIndex(v => v.id === id || v.name === id));
+  Handlebars.registerHelper('itemIndex', (items: any[], id: string) =>
+    (items || []).findIndex(i => i.id === id || i.name === id));
+  Handlebars.registerHelper('perfectHash', (items: any[]) =>
+    perfectHash(items || []));
+  Handlebars.registerHelper('packTiles',
+    (rows: any[], width: number, height: number, bits: number) =>
+      packTiles(rows || [], width || 0, height || 0, bits));
+  Handlebars.registerHelper('sensorRows', (sensors: any[], height: number) =>
+    sensorRows(sensors || [], height || 0));
+  Handlebars.registerHelper('compileEvents', (events: any[], options: any) => {
+    const code = compileEvents(events || [], options.data.root);
+
+    return { words: formatCode(code), size: code.length };
+  });
+  Handlebars.registerHelper('maxItems', (items: any[], key: string) =>
+    Math.max(1, ...(items || []).map(i => [].concat(i?.[key] || []).length)));
   Handlebars.registerHelper('posix', (p: string) =>
     p.replace(/\s/g, '\\ ').replace(/\\/g, '/'));
   Handlebars.registerHelper('isRawValue', (obj: any) =>
@@ -71,21 +217,6 @@ export const setupHandlebars = async () => {
     ),
   );
 
-  Handlebars.registerPartial(
-    'ifConditionsPartial',
-    (await fse.readFile(path.join(
-      getResourcesDir(),
-      './public/templates/commons/templates/partials/if-conditions.tpl.h'
-    ), 'utf-8'))
-  );
-
-  Handlebars.registerPartial(
-    'ifExpressionsPartial',
-    (await fse.readFile(path.join(
-      getResourcesDir(),
-      './public/templates/commons/templates/partials/if-expressions.tpl.h'
-    ), 'utf-8'))
-  );
 
   Handlebars.registerPartial(
     'valuePartial',
@@ -0,0 +1,118 @@
+// Typed project variables. Every variable keeps a single int at runtime
+// (see neo::variables::registry), its type only changes how that int is
+// read: ints as is, bools as 0 or 1, fixed point as 4096 = 1.0 and strings
+// as an index in the string table, -1 for a string that is not in it.
+// Constants are converted here so the runtime never parses values.
+
+// Must match neo::variables::type
+export const TYPES = ['int', 'bool', 'fixed', 'string'];
+
+export type VariableType = 'int' | 'bool' | 'fixed' | 'string';
+
+const FIXED_ONE = 4096;
+
+export const flatVariables = (variables: any[] | undefined) =>
+  (variables || []).flatMap(v => v.values || []);
+
+export const variableSlot = (variables: any[] | undefined, id: string) =>
+  flatVariables(variables).findIndex(v => v.id === id || v.name === id);
+
+// Types come from the default values, numbers typed as text included
+export const valueType = (value: any): VariableType => {
+  if (typeof value === 'boolean' || value === 'true' || value === 'false') {
+    return 'bool';
+  }
+
+  const text = String(value ?? '').trim();
+
+  if (typeof value === 'number' || (text && !isNaN(Number(text)))) {
+    return Number.isInteger(Number(text)) ? 'int' : 'fixed';
+  }
+
+  return 'string';
+};
+
+export const variableType = (variables: any[] | undefined, slot: number) =>
+  slot >= 0
+    ? valueType(flatVariables(variables)[slot]?.defaultValue)
+    : 'int';
+
+// The constant of a value, editor values can be wrapped in an object
+export const constantValue = (value: any) =>
+  value !== null && typeof value === 'object' ? value.value : value;
+
+// String variables can hold: their defaults and the values set-variable
+// events give them, in the order they are found
+const stringTables = new WeakMap<object, string[]>();
+
+const collectEvents = (events: any[] | undefined): any[] =>
+  [].concat(events || []).flatMap((event: any) => [
+    event,
+    ...collectEvents(event?.then),
+    ...collectEvents(event?.else),
+    ...collectEvents(event?.events),
+  ]);
+
+export const projectEvents = (project: any) => [
+  ...(project.scenes || []).flatMap((scene: any) => [
+    ...collectEvents(scene.events),
+    ...(scene.map?.sensors || []).flatMap((sensor: any) => [
+      ...collectEvents(sensor.events),
+      ...collectEvents(sensor.exitEvents),
+    ]),
+    ...(scene.actors || []).flatMap((actor: any) => [
+      ...collectEvents(actor.events?.init),
+      ...collectEvents(actor.events?.interact),
+      ...collectEvents(actor.events?.update),
+    ]),
+  ]),
+  ...(project.scripts || []).flatMap((script: any) =>
+    collectEvents(script.events)),
+];
+
+export const stringTable = (project: any) => {
+  const variables = project.variables || [];
+
+  if (stringTables.has(project)) {
+    return stringTables.get(project);
+  }
+
+  const strings = new Set<string>();
+
+  flatVariables(variables)
+    .filter(v => valueType(v.defaultValue) === 'string')
+    .forEach(v => strings.add(String(v.defaultValue ?? '')));
+
+  projectEvents(project)
+    .filter(e => e?.type === 'set-variable' && e.value?.type !== 'variable')
+    .filter(e => variableType(variables, variableSlot(variables, e.name)) ===
+      'string')
+    .forEach(e => strings.add(String(constantValue(e.value) ?? '')));
+
+  const table = [...strings];
+  stringTables.set(project, table);
+
+  return table;
+};
+
+const toNumber = (value: any) => {
+  if (value === true || value === 'true') {
+    return 1;
+  }
+
+  return Number(value) || 0;
+};
+
+// The runtime int of a constant read as type
+export const toRaw = (project: any, value: any, type: VariableType) => {
+  switch (type) {
+    case 'bool':
+      return toNumber(value) !== 0 ? 1 : 0;
+    case 'fixed':
+      return Math.round(toNumber(value) * FIXED_ONE);
+    case 'string':
+      return stringTable(project).indexOf(String(value ?? ''));
+    default:
+      return Math.trunc(toNumber(value));
+  }
+};
@@ -15,6 +15,7 @@ import type {
   GameVariables,
   IfEvent,
   OnButtonPressEvent,
+  OnVariableChangeEvent,
   SceneEvent,
 } from '../types';
 import { getResourcesDir } from './utils';
@@ -44,6 +45,14 @@ export const sanitizeEvent = async (event: SceneEvent): Promise<SceneEvent> => {
     }
   }
 
+  if (event.type === 'on-variable-change') {
+    const evt = event as OnVariableChangeEvent;
+
+    for (const e of evt.events ?? []) {
+      await sanitizeEvent(e);
+    }
+  }
+
   return event;
 };
 
@@ -79,11 +88,16 @@ export const sanitizeSensor = async (
 
   sensor.width = Number(sensor.width ?? 1);
   sensor.height = Number(sensor.height ?? 1);
+  sensor.priority = Number(sensor.priority ?? 0);
 
   for (const event of sensor.events ?? []) {
     await sanitizeEvent(event);
   }
 
+  for (const event of sensor.exitEvents ?? []) {
+    await sanitizeEvent(event);
+  }
+
   return sensor;
 };
 
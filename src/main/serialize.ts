@@ -1,27 +1,34 @@
 import type { AppPayload, GameScene } from '../types';
 
+// Tile layers are saved as one comma separated string per row
+const TILE_LAYERS = ['collisions', 'attributes'] as const;
+
 export const serializeScene = (scene: GameScene): GameScene => {
-  if (scene.map?.collisions?.length) {
-    if (!Array.isArray(scene.map.collisions[0])) {
-      return scene;
+  TILE_LAYERS.forEach(layer => {
+    const rows = scene.map?.[layer];
+
+    if (!rows?.length || !Array.isArray(rows[0])) {
+      return;
     }
 
     // @ts-expect-error - we know this is a 2D array
-    scene.map.collisions = scene.map.collisions.map(l => l.join(','));
-  }
+    scene.map[layer] = rows.map(l => l.join(','));
+  });
 
   return scene;
 };
 
 export const unserializeScene = (scene: GameScene): GameScene => {
-  if (scene.map?.collisions?.length) {
-    if (Array.isArray(scene.map.collisions[0])) {
-      return scene;
+  TILE_LAYERS.forEach(layer => {
+    const rows = scene.map?.[layer];
+
+    if (!rows?.length || Array.isArray(rows[0])) {
+      return;
     }
 
     // @ts-expect-error - we know this is a string array
-    scene.map.collisions = scene.map.collisions.map(l => l.split(','));
-  }
+    scene.map[layer] = rows.map(l => l.split(','));
+  });
 
   return scene;
 };
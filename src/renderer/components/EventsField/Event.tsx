@@ -24,11 +24,13 @@ import type {
   IfEvent,
   MoveCameraToEvent,
   OnButtonPressEvent,
+  OnVariableChangeEvent,
   PlayMusicEvent,
   PlaySoundEvent,
   SceneEvent,
   SetVariableEvent,
   ShowDialogEvent,
+  UpdateVariableEvent,
   WaitEvent,
   WaitForButtonEvent,
 } from '../../../types';
@@ -40,6 +42,8 @@ import EventGoToScene from './EventGoToScene';
 import EventPlayMusic from './EventPlayMusic';
 import EventButtons from './EventButtons';
 import EventSetVariable from './EventSetVariable';
+import EventUpdateVariable from './EventUpdateVariable';
+import EventVariableChange from './EventVariableChange';
 import EventShowDialog from './EventShowDialog';
 import EventActor from './EventActor';
 import EventIf from './EventIf';
@@ -312,6 +316,18 @@ const Event = ({
                 onValueChange={onValueChange}
               />
             </Switch.Case>
+            <Switch.Case value="update-variable">
+              <EventUpdateVariable
+                event={event as UpdateVariableEvent}
+                onValueChange={onValueChange}
+              />
+            </Switch.Case>
+            <Switch.Case value="on-variable-change">
+              <EventVariableChange
+                event={event as OnVariableChangeEvent}
+                onValueChange={onValueChange}
+              />
+            </Switch.Case>
             <Switch.Case value="show-dialog">
               <EventShowDialog
                 event={event as ShowDialogEvent}
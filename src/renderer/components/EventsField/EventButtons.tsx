@@ -33,7 +33,7 @@ const EventButtons = ({
 
   return (
     <div className="flex flex-col gap-4">
-      { event.type === 'wait-for-button' && (
+      <div className="flex gap-4">
         <div className="flex flex-col items-start gap-2">
           <Text size="1" className="text-slate">Mode</Text>
           <SegmentedControl.Root
@@ -49,7 +49,25 @@ const EventButtons = ({
             </SegmentedControl.Item>
           </SegmentedControl.Root>
         </div>
-      ) }
+        <div className="flex flex-col items-start gap-2">
+          <Text size="1" className="text-slate">Trigger</Text>
+          <SegmentedControl.Root
+            size="1"
+            value={event.trigger ?? 'pressed'}
+            onValueChange={onValueChange_.bind(null, 'trigger')}
+          >
+            <SegmentedControl.Item value="pressed">
+              Pressed
+            </SegmentedControl.Item>
+            <SegmentedControl.Item value="held">
+              Held
+            </SegmentedControl.Item>
+            <SegmentedControl.Item value="released">
+              Released
+            </SegmentedControl.Item>
+          </SegmentedControl.Root>
+        </div>
+      </div>
       <div className="flex flex-col gap-2">
         <Text size="1" className="text-slate">Buttons</Text>
         <ToggleGroup.Root
@@ -1,6 +1,6 @@
 import { useMemo } from 'react';
-import { Card, Inset, Select, Text } from '@radix-ui/themes';
-import { set } from '@junipero/react';
+import { Button, Card, Inset, Select, Text } from '@radix-ui/themes';
+import { classNames, set } from '@junipero/react';
 
 import type { EventValue, IfEvent, IfEventCondition } from '../../../types';
 import EventValueField from '../EventValueField';
@@ -78,29 +78,75 @@ export interface EventIfConditionProps {
   onValueChange?: (condition: IfEventCondition) => void;
 }
 
+const isLogical = (operator: string) => ['&&', '||'].includes(operator);
+
+const isCondition = (value: any): value is IfEventCondition =>
+  value?.type === 'condition';
+
+const newCondition = (): IfEventCondition => ({
+  type: 'condition', left: '', operator: '==', right: '',
+});
+
 const EventIfCondition = ({
   condition,
   onValueChange,
 }: EventIfConditionProps) => {
-  const onConditionValueChange = (name: string, value: EventValue | string) => {
+  const onConditionValueChange = (name: string, value: any) => {
     set(condition, name, value);
     onValueChange?.(condition);
   };
 
-  return (
-    <div className="flex items-center gap-2">
-      { (condition.left as IfEventCondition).type !== 'condition' && (
-        <EventValueField
-          type="text"
-          className="!flex-auto"
-          value={condition.left as EventValue}
-          onValueChange={onConditionValueChange.bind(null, 'left')}
+  // && and || combine two conditions, other operators compare two values
+  const onOperatorChange = (operator: string) => {
+    if (isLogical(operator) !== isLogical(condition.operator)) {
+      set(condition, 'left', isLogical(operator) ? newCondition() : '');
+      set(condition, 'right', isLogical(operator) ? newCondition() : '');
+    }
+
+    onConditionValueChange('operator', operator);
+  };
+
+  const side = (name: 'left' | 'right') => {
+    const value = condition[name];
+
+    return isCondition(value) ? (
+      <Card className="!flex-auto">
+        <EventIfCondition
+          condition={value}
+          onValueChange={onConditionValueChange.bind(null, name)}
         />
-      ) }
+      </Card>
+    ) : (
+      <EventValueField
+        type="text"
+        className="!flex-auto"
+        value={value as EventValue}
+        onValueChange={onConditionValueChange.bind(null, name)}
+      />
+    );
+  };
+
+  return (
+    <div
+      className={classNames(
+        'flex gap-2',
+        isLogical(condition.operator) ? 'flex-col' : 'items-center',
+      )}
+    >
+      <Button
+        size="1"
+        variant={condition.negate ? 'soft' : 'ghost'}
+        color={condition.negate ? undefined : 'gray'}
+        className="!self-start flex-none"
+        onClick={() => onConditionValueChange('negate', !condition.negate)}
+      >
+        NOT
+      </Button>
+      { side('left') }
       <Select.Root
         size="1"
         value={condition.operator}
-        onValueChange={onConditionValueChange.bind(null, 'operator')}
+        onValueChange={onOperatorChange}
       >
         <Select.Trigger
           className="flex-none"
@@ -110,18 +156,15 @@ const EventIfCondition = ({
         <Select.Content>
           <Select.Item value="==">==</Select.Item>
           <Select.Item value="!=">!=</Select.Item>
+          <Select.Item value="<">{'<'}</Select.Item>
+          <Select.Item value="<=">{'<='}</Select.Item>
+          <Select.Item value=">">{'>'}</Select.Item>
+          <Select.Item value=">=">{'>='}</Select.Item>
           <Select.Item value="&&">&&</Select.Item>
           <Select.Item value="||">||</Select.Item>
         </Select.Content>
       </Select.Root>
-      { (condition.right as IfEventCondition).type !== 'condition' && (
-        <EventValueField
-          type="text"
-          className="!flex-auto"
-          value={condition.right as EventValue}
-          onValueChange={onConditionValueChange.bind(null, 'right')}
-        />
-      ) }
+      { side('right') }
     </div>
   );
 };
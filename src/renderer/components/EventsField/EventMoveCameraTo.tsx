@@ -115,6 +115,22 @@ const EventMoveCameraTo = ({
           <TextField.Slot side="right">ms</TextField.Slot>
         </EventValueField>
       </div>
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">Easing</Text>
+        <Select.Root
+          value={event.easing || 'linear'}
+          onValueChange={onValueChange_.bind(null, 'easing')}
+        >
+          <Select.Trigger placeholder="Select" />
+          <Select.Content>
+            <Select.Item value="linear">Linear</Select.Item>
+            <Select.Item value="ease-in">Ease in</Select.Item>
+            <Select.Item value="ease-out">Ease out</Select.Item>
+            <Select.Item value="ease-in-out">Ease in & out</Select.Item>
+            <Select.Item value="smoothstep">Smoothstep</Select.Item>
+          </Select.Content>
+        </Select.Root>
+      </div>
       <div className="flex flex-col gap-2">
         <Text size="1" className="text-slate">Allow Diagonal</Text>
         <Switch
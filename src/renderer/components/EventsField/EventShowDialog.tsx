@@ -1,6 +1,6 @@
 import { type ChangeEvent, useCallback, useState } from 'react';
 import { set } from '@junipero/react';
-import { Text, TextArea } from '@radix-ui/themes';
+import { Slider, Text, TextArea } from '@radix-ui/themes';
 
 import type {
   ShowDialogEvent,
@@ -31,6 +31,13 @@ const EventShowDialog = ({
     onDelayedValueChange?.(event);
   }, [event, onDelayedValueChange]);
 
+  const onSliderChange = useCallback((name: string, value: number[]) => {
+    // New object so the slider re-renders while dragging
+    const next = { ...event, [name]: value[0] };
+    setEvent(next);
+    onDelayedValueChange?.(next);
+  }, [event, onDelayedValueChange]);
+
   return (
     <div className="flex flex-col gap-4">
       <div className="flex flex-col gap-2">
@@ -41,6 +48,20 @@ const EventShowDialog = ({
           onChange={onChange.bind(null, 'text')}
         />
       </div>
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">Speed</Text>
+        <div className="flex items-center gap-2">
+          <Slider
+            min={1}
+            max={16}
+            value={[event.speed ?? 4]}
+            onValueChange={onSliderChange.bind(null, 'speed')}
+          />
+          <Text className="block w-[60px] text-right">
+            { event.speed ?? 4 }/frame
+          </Text>
+        </div>
+      </div>
     </div>
   );
 };
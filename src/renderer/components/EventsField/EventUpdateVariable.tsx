@@ -0,0 +1,96 @@
+import { useCallback, useState } from 'react';
+import { set } from '@junipero/react';
+import { Select, Text } from '@radix-ui/themes';
+
+import type {
+  UpdateVariableEvent,
+} from '../../../types';
+import { useDelayedCallback } from '../../services/hooks';
+import VariablesListField from '../VariablesListField';
+import EventValueField from '../EventValueField';
+
+export interface EventUpdateVariableProps {
+  event: UpdateVariableEvent;
+  onValueChange?: (
+    event: UpdateVariableEvent,
+  ) => void;
+}
+
+const EventUpdateVariable = ({
+  event: eventProp,
+  onValueChange,
+}: EventUpdateVariableProps) => {
+  const [event, setEvent] = useState(eventProp);
+  // Performance optimizations
+  const onDelayedValueChange = useDelayedCallback(onValueChange, 300);
+
+  const onValueChange_ = useCallback((name: string, val: any) => {
+    set(event, name, val);
+    setEvent({ ...event });
+    onDelayedValueChange?.(event);
+  }, [event, onDelayedValueChange]);
+
+  const operation = event.operation || 'inc';
+
+  return (
+    <div className="flex flex-col gap-4">
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">Variable</Text>
+        <VariablesListField
+          value={event.name}
+          onValueChange={onValueChange_.bind(null, 'name')}
+        />
+      </div>
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">Operation</Text>
+        <Select.Root
+          value={operation}
+          onValueChange={onValueChange_.bind(null, 'operation')}
+        >
+          <Select.Trigger placeholder="Select" />
+          <Select.Content>
+            <Select.Item value="inc">Increment</Select.Item>
+            <Select.Item value="dec">Decrement</Select.Item>
+            <Select.Item value="add">Add</Select.Item>
+            <Select.Item value="sub">Subtract</Select.Item>
+            <Select.Item value="mul">Multiply</Select.Item>
+            <Select.Item value="clamp">Clamp</Select.Item>
+            <Select.Item value="random">Random</Select.Item>
+          </Select.Content>
+        </Select.Root>
+      </div>
+      { ['add', 'sub', 'mul'].includes(operation) && (
+        <div className="flex flex-col gap-2">
+          <Text size="1" className="text-slate">Value</Text>
+          <EventValueField
+            type="text"
+            value={event.value}
+            onValueChange={onValueChange_.bind(null, 'value')}
+          />
+        </div>
+      ) }
+      { ['clamp', 'random'].includes(operation) && (
+        <div className="grid grid-cols-2 gap-2">
+          <div className="flex flex-col gap-2">
+            <Text size="1" className="text-slate">Min</Text>
+            <EventValueField
+              type="text"
+              value={event.min}
+              onValueChange={onValueChange_.bind(null, 'min')}
+            />
+          </div>
+          <div className="flex flex-col gap-2">
+            <Text size="1" className="text-slate">Max</Text>
+            <EventValueField
+              type="text"
+              value={event.max}
+              onValueChange={onValueChange_.bind(null, 'max')}
+            />
+          </div>
+        </div>
+      ) }
+    </div>
+  );
+};
+
+export default EventUpdateVariable;
@@ -0,0 +1,80 @@
+import { Card, Inset, Select, Text } from '@radix-ui/themes';
+import { set } from '@junipero/react';
+
+import type { EventValue, OnVariableChangeEvent } from '../../../types';
+import VariablesListField from '../VariablesListField';
+import EventValueField from '../EventValueField';
+import EventsField from '.';
+
+export interface EventVariableChangeProps {
+  event: OnVariableChangeEvent;
+  onValueChange?: (event: OnVariableChangeEvent) => void;
+}
+
+const EventVariableChange = ({
+  event,
+  onValueChange,
+}: EventVariableChangeProps) => {
+  const onValueChange_ = (name: string, value: any) => {
+    set(event, name, value);
+    onValueChange?.(event);
+  };
+
+  return (
+    <div className="flex flex-col gap-4">
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">Variable</Text>
+        <VariablesListField
+          value={event.name}
+          onValueChange={onValueChange_.bind(null, 'name')}
+        />
+      </div>
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">New value</Text>
+        <div className="flex items-center gap-2">
+          <Select.Root
+            size="1"
+            value={event.operator || 'any'}
+            onValueChange={onValueChange_.bind(null, 'operator')}
+          >
+            <Select.Trigger
+              className="flex-none"
+              placeholder="any"
+              variant="ghost"
+            />
+            <Select.Content>
+              <Select.Item value="any">any</Select.Item>
+              <Select.Item value="==">==</Select.Item>
+              <Select.Item value="!=">!=</Select.Item>
+              <Select.Item value="<">{'<'}</Select.Item>
+              <Select.Item value="<=">{'<='}</Select.Item>
+              <Select.Item value=">">{'>'}</Select.Item>
+              <Select.Item value=">=">{'>='}</Select.Item>
+            </Select.Content>
+          </Select.Root>
+          { event.operator && event.operator !== 'any' && (
+            <EventValueField
+              type="text"
+              className="!flex-auto"
+              value={event.value as EventValue}
+              onValueChange={onValueChange_.bind(null, 'value')}
+            />
+          ) }
+        </div>
+      </div>
+      <div className="flex flex-col gap-2">
+        <Text size="1" className="text-slate">Events</Text>
+        <Card>
+          <Inset>
+            <EventsField
+              value={event.events ?? []}
+              onValueChange={onValueChange_.bind(null, 'events')}
+            />
+          </Inset>
+        </Card>
+      </div>
+    </div>
+  );
+};
+
+export default EventVariableChange;
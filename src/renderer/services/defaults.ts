@@ -34,7 +34,9 @@ export const DEFAULT_SENSOR: GameSensor = {
   y: 0,
   width: 1,
   height: 1,
+  priority: 0,
   events: [],
+  exitEvents: [],
 };
 
 export const DEFAULT_SPRITE: GameSprite = {
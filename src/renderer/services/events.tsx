@@ -7,10 +7,12 @@ import {
   GroupIcon,
   LapTimerIcon,
   LayersIcon,
+  LightningBoltIcon,
   MixIcon,
   MoveIcon,
   Pencil1Icon,
   PlayIcon,
+  PlusCircledIcon,
   ShadowIcon,
   ShadowNoneIcon,
   SpeakerLoudIcon,
@@ -24,6 +26,7 @@ import type {
   ListCategory,
   ListItem,
   OnButtonPressEvent,
+  OnVariableChangeEvent,
   SceneEvent,
 } from '../../types';
 
@@ -130,6 +133,30 @@ export const AVAILABLE_EVENTS: ListCategory<EventDefinition>[] = [{
       name: '',
       value: '',
     }),
+  }, {
+    icon: PlusCircledIcon,
+    name: 'Update Variable',
+    value: 'update-variable',
+    keywords: [
+      'variable', 'update', 'increment', 'decrement', 'add', 'subtract',
+      'multiply', 'clamp', 'random',
+    ],
+    construct: () => ({
+      type: 'update-variable',
+      name: '',
+      operation: 'inc',
+    }),
+  }, {
+    icon: LightningBoltIcon,
+    name: 'On Variable Change',
+    value: 'on-variable-change',
+    keywords: ['variable', 'change', 'watch', 'trigger'],
+    construct: () => ({
+      type: 'on-variable-change',
+      name: '',
+      operator: 'any',
+      events: [],
+    }),
   }],
 }, {
   name: 'Sound',
@@ -222,6 +249,11 @@ export const getEventsOfType = <T extends SceneEvent>(
       acc.push(...getEventsOfType<T>(type, evt.events || []));
     }
 
+    if (event.type === 'on-variable-change') {
+      const evt = event as OnVariableChangeEvent;
+      acc.push(...getEventsOfType<T>(type, evt.events || []));
+    }
+
     if (event.type === 'execute-script' && opts?.scripts) {
       const evt = event as ExecuteScriptEvent;
       const script = opts.scripts
@@ -202,6 +202,47 @@ const SceneForm = ({
                   onValueChange={onValueChange.bind(null, 'player.z')}
                 />
               </div>
+              <div className="flex flex-col gap-2">
+                <div className="grid grid-cols-3 gap-2">
+                  <div className="flex flex-col gap-2">
+                    <Text size="1" className="text-slate">Deadzone X</Text>
+                    <EventValueField
+                      type="number"
+                      min={0}
+                      value={scene.player?.camera?.deadzoneX ?? 0}
+                      onValueChange={onValueChange
+                        .bind(null, 'player.camera.deadzoneX')}
+                    >
+                      <TextField.Slot side="right">px</TextField.Slot>
+                    </EventValueField>
+                  </div>
+                  <div className="flex flex-col gap-2">
+                    <Text size="1" className="text-slate">Deadzone Y</Text>
+                    <EventValueField
+                      type="number"
+                      min={0}
+                      value={scene.player?.camera?.deadzoneY ?? 0}
+                      onValueChange={onValueChange
+                        .bind(null, 'player.camera.deadzoneY')}
+                    >
+                      <TextField.Slot side="right">px</TextField.Slot>
+                    </EventValueField>
+                  </div>
+                  <div className="flex flex-col gap-2">
+                    <Text size="1" className="text-slate">Camera speed</Text>
+                    <EventValueField
+                      type="number"
+                      min={1}
+                      max={100}
+                      value={scene.player?.camera?.lerp ?? 100}
+                      onValueChange={onValueChange
+                        .bind(null, 'player.camera.lerp')}
+                    >
+                      <TextField.Slot side="right">%</TextField.Slot>
+                    </EventValueField>
+                  </div>
+                </div>
+              </div>
             </div>
           </>
         ) }
@@ -127,6 +127,14 @@ const SensorForm = ({
             </TextField.Root>
           </div>
         </div>
+        <div className="flex flex-col gap-2">
+          <Text className="block text-slate" size="1">Priority</Text>
+          <TextField.Root
+            type="number"
+            value={sensor.priority ?? 0}
+            onChange={onTextChange.bind(null, 'priority')}
+          />
+        </div>
       </div>
       <Inset side="x"><Separator className="!w-full my-4" /></Inset>
       <div className="flex flex-col gap-6">
@@ -138,6 +146,16 @@ const SensorForm = ({
           />
         </Inset>
       </div>
+      <Inset side="x"><Separator className="!w-full my-4" /></Inset>
+      <div className="flex flex-col gap-6">
+        <Text className="block text-slate" size="1">Exit events</Text>
+        <Inset>
+          <EventsField
+            value={sensor.exitEvents ?? []}
+            onValueChange={onValueChange.bind(null, 'exitEvents')}
+          />
+        </Inset>
+      </div>
     </div>
   );
 };
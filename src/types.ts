@@ -67,6 +67,8 @@ export interface GameMap {
   gridSize: number;
   scene?: string;
   collisions?: string[][];
+  // Per-tile flags (0-15) for the game to interpret, e.g. water or ladders
+  attributes?: string[][];
   sensors?: GameSensor[];
 }
 
@@ -79,6 +81,11 @@ export interface GamePlayer {
   height?: number;
   direction?: Direction;
   sprite?: string;
+  camera?: {
+    deadzoneX?: number; // Pixels, the camera stays still within them
+    deadzoneY?: number;
+    lerp?: number; // Percent of the distance closed per frame
+  };
 }
 
 export interface GameScene {
@@ -144,7 +151,10 @@ export interface GameSensor {
   y: number;
   width: number;
   height: number;
+  // Overlapping sensors run from the highest priority down
+  priority?: number;
   events?: SceneEvent[];
+  exitEvents?: SceneEvent[];
   // Internals
   id: string;
 }
@@ -273,15 +283,22 @@ export interface PlaySoundEvent extends SceneEvent {
   priority?: number;
 }
 
+// When a button set fires: the frame a key goes down, every frame it is
+// down, or the frame it comes back up
+export type ButtonTrigger = 'pressed' | 'held' | 'released';
+
 export interface WaitForButtonEvent extends SceneEvent {
   type: 'wait-for-button';
   buttons: string[];
   every?: boolean;
+  trigger?: ButtonTrigger;
 }
 
 export interface OnButtonPressEvent extends SceneEvent {
   type: 'on-button-press';
   buttons: string[];
+  every?: boolean;
+  trigger?: ButtonTrigger;
   events?: SceneEvent[];
 }
 
@@ -291,9 +308,31 @@ export interface SetVariableEvent extends SceneEvent {
   value: EventValue;
 }
 
+export type UpdateVariableOperation =
+  'inc' | 'dec' | 'add' | 'sub' | 'mul' | 'clamp' | 'random';
+
+export interface UpdateVariableEvent extends SceneEvent {
+  type: 'update-variable';
+  name: string;
+  operation: UpdateVariableOperation;
+  value?: EventValue;
+  min?: EventValue;
+  max?: EventValue;
+}
+
+export interface OnVariableChangeEvent extends SceneEvent {
+  type: 'on-variable-change';
+  name: string;
+  // Filter on the new value, any change fires when left out
+  operator?: 'any' | '==' | '!=' | '<' | '<=' | '>' | '>=';
+  value?: EventValue;
+  events?: SceneEvent[];
+}
+
 export interface ShowDialogEvent extends SceneEvent {
   type: 'show-dialog';
   text: string;
+  speed?: number; // Characters revealed per frame
 }
 
 export interface DisableActorEvent extends SceneEvent {
@@ -313,13 +352,15 @@ export interface MoveCameraToEvent extends SceneEvent {
   duration?: EventValue;
   allowDiagonal?: boolean;
   directionPriority?: 'horizontal' | 'vertical';
+  easing?: 'linear' | 'ease-in' | 'ease-out' | 'ease-in-out' | 'smoothstep';
 }
 
 export interface IfEventCondition {
   type: 'condition';
   left: EventValue | IfEventCondition;
-  operator: 'eq' | 'neq' | '&&' | '||';
+  operator: 'eq' | 'neq' | '<' | '<=' | '>' | '>=' | '&&' | '||';
   right: EventValue | IfEventCondition;
+  negate?: boolean;
 }
 
 export interface IfEvent extends SceneEvent {